@@ -29,6 +29,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "win32/ScreenWin32.h"
 #include "tty/InputTTY.h"
 #include "tty/ScreenTTY.h"
+#include "headless/InputHeadless.h"
+#include "headless/ScreenHeadless.h"
 
 
 //////////////////////////////////////////////////////////////////////////////
@@ -47,8 +49,44 @@ class Console final
     InputTTY    m_input;
     ScreenTTY   m_screen;
 #endif
+    //backend without terminal for scripted runs
+    InputHeadless  m_headlessInput;
+#ifndef WIN32
+    ScreenHeadless m_headlessScreen;
+#endif
+
+    ConsoleInput*  m_pInput {&m_input};
+    ConsoleScreen* m_pScreen {&m_screen};
 
 public:
+    //must be called before Init
+    bool SetHeadless([[maybe_unused]] pos_t sizex, [[maybe_unused]] pos_t sizey)
+    {
+#ifdef WIN32
+        //headless output uses terminal encoder
+        return false;
+#else
+        m_headlessInput.m_StepCallback = [this](const std::string& name) {
+            m_headlessScreen.BeginStep(name);
+        };
+        m_pInput = &m_headlessInput;
+        m_pScreen = &m_headlessScreen;
+        return m_headlessScreen.SetSize(sizex, sizey);
+#endif
+    }
+    bool AddScriptStep(const std::string& name, const keybuff_t& keys)
+        {return m_headlessInput.AddStep(name, keys);}
+    const std::vector<HeadlessStep>& GetScriptReport()
+    {
+#ifdef WIN32
+        static const std::vector<HeadlessStep> steps;
+        return steps;
+#else
+        m_headlessScreen.BeginStep({});
+        return m_headlessScreen.GetSteps();
+#endif
+    }
+
     bool Init()
     {
 #ifndef WIN32        
@@ -57,13 +95,16 @@ public:
                    && m_screen.SetSize(x, y);
             return rc;       
         };
+        m_input.m_ModeCallback = [this](int mode, int value) {
+            m_screen.ModeReport(mode, value);
+        };
 #endif        
-        return m_input.Init() 
-            && m_screen.Init();
+        return m_pInput->Init() 
+            && m_pScreen->Init();
     }
     
     void Deinit()
-        {m_input.Deinit(); m_screen.Deinit();}
+        {m_pInput->Deinit(); m_pScreen->Deinit();}
 
     bool SetScreenSize([[maybe_unused]]pos_t sizex, [[maybe_unused]] pos_t sizey)
     { 
@@ -75,65 +116,75 @@ public:
     }
 
     bool InputPending(const std::chrono::milliseconds& waitTime = 500ms)
-        {return m_input.InputPending(waitTime);}
+        {return m_pInput->InputPending(waitTime);}
     bool PutInput(const input_t code)
-        {return m_input.PutInput(code);}
+        {return m_pInput->PutInput(code);}
     bool PutMacro(const input_t code)
-        {return m_input.PutMacro(code);}
+        {return m_pInput->PutMacro(code);}
     size_t GetInputLen()
-        {return m_input.GetInputLen();}
+        {return m_pInput->GetInputLen();}
     input_t GetInput()
-        {return m_input.GetInput();}
+        {return m_pInput->GetInput();}
+    const std::u16string& GetPaste() const
+        {return m_pInput->GetPaste();}
     void ClearMacro()
-        {m_input.ClearMacro();}
+        {m_pInput->ClearMacro();}
     bool PlayMacro()
-        {return m_input.PlayMacro();}
+        {return m_pInput->PlayMacro();}
 
     bool WriteConsoleTitle(const std::string& title)
-        {return m_screen.WriteConsoleTitle(title);}
+        {return m_pScreen->WriteConsoleTitle(title);}
     bool Beep()
-        {return m_screen.Beep();}
+        {return m_pScreen->Beep();}
     bool WriteChar(char16_t c)
-        {return m_screen.WriteChar(c);}
+        {return m_pScreen->WriteChar(c);}
     bool WriteStr(const std::u16string& str)
-        {return m_screen.WriteStr(str);}
+        {return m_pScreen->WriteStr(str);}
 
     bool GotoXY(pos_t x, pos_t y)
-        {return m_screen.GotoXY(x, y);}
+        {return m_pScreen->GotoXY(x, y);}
     bool ClrScr()
-        {return m_screen.ClrScr();}
+        {return m_pScreen->ClrScr();}
     bool SetCursor(cursor_t cursor)
-        {return m_screen.SetCursor(cursor);}
+        {return m_pScreen->SetCursor(cursor);}
     bool SetTextAttr(color_t color)
-        {return m_screen.SetTextAttr(color);}
+        {return m_pScreen->SetTextAttr(color);}
 
     bool Left()
-        {return m_screen.Left();}
+        {return m_pScreen->Left();}
     bool Right()
-        {return m_screen.Left();}
+        {return m_pScreen->Left();}
     bool Up()
-        {return m_screen.Up();}
+        {return m_pScreen->Up();}
     bool Down()
-        {return m_screen.Down();}
+        {return m_pScreen->Down();}
 
     bool ScrollBlock(pos_t left, pos_t top, pos_t right, pos_t bottom,
         pos_t n, scroll_t mode, uint32_t* invalidate = NULL)
-        {return m_screen.ScrollBlock(left, top, right, bottom, n, mode, invalidate);}
+        {return m_pScreen->ScrollBlock(left, top, right, bottom, n, mode, invalidate);}
     bool WriteLastChar(char16_t prevC, char16_t lastC)
-        {return m_screen.WriteLastChar(prevC, lastC);}
+        {return m_pScreen->WriteLastChar(prevC, lastC);}
     bool WriteBlock(
         pos_t left, pos_t top, pos_t right, pos_t bottom,
         const ScreenBuffer& block, pos_t xoffset = 0, pos_t yoffset = 0)
-        {return m_screen.WriteBlock(left, top, right, bottom, block, xoffset, yoffset);}
+        {return m_pScreen->WriteBlock(left, top, right, bottom, block, xoffset, yoffset);}
 
     bool Flush()
-        {return m_screen.Flush();}
+        {return m_pScreen->Flush();}
+
+    bool OutputPending() const
+        {return 0 != m_pScreen->OutputPending();}
+    bool WaitOutput(const std::chrono::milliseconds& waitTime)
+        {return m_pScreen->WaitOutput(waitTime);}
 
     void GetScreenSize(pos_t& sizex, pos_t& sizey) const
     {
-        sizex = m_screen.m_sizex;
-        sizey = m_screen.m_sizey;
+        sizex = m_pScreen->m_sizex;
+        sizey = m_pScreen->m_sizey;
     }
+
+    void GetOutputStat(size_t& writes, size_t& bytes) const
+        {m_pScreen->GetOutputStat(writes, bytes);}
 };
 
 } //namespace _Console
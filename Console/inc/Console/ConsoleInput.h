@@ -44,6 +44,9 @@ class InputBuffer
 protected:
     keybuff_t m_keyBuff;
     keybuff_t m_macroBuff;
+    //text for K_PASTE events in key buffer
+    std::list<std::u16string> m_pasteBuff;
+    std::u16string m_paste;
 
 public:
     bool PutInput(const input_t Code)
@@ -72,6 +75,20 @@ public:
         return true;
     }
 
+    bool PutPaste(std::u16string&& str)
+    {
+        try
+        {
+            m_pasteBuff.push_back(std::move(str));
+            m_keyBuff.push_back(K_PASTE);
+        }
+        catch(...)
+        {
+            return false;
+        }
+        return true;
+    }
+
     input_t GetInput()
     {
         if(m_keyBuff.empty())
@@ -79,9 +96,20 @@ public:
 
         input_t code = m_keyBuff.front();
         m_keyBuff.pop_front();
+        if(code == K_PASTE && !m_pasteBuff.empty())
+        {
+            m_paste = std::move(m_pasteBuff.front());
+            m_pasteBuff.pop_front();
+        }
         return code;
     }
 
+    //text of the last K_PASTE event
+    const std::u16string& GetPaste() const
+    {
+        return m_paste;
+    }
+
     size_t GetInputLen()
     {
         return m_keyBuff.size();
@@ -120,6 +148,7 @@ public:
 };
 
 using ResizeFunction = std::function<bool(pos_t& x, pos_t& y)>;
+using ModeFunction = std::function<void(int mode, int value)>;
 
 //////////////////////////////////////////////////////////////////////////////
 class ConsoleInput : public InputBuffer
@@ -128,6 +157,7 @@ friend class Console;
 
 protected:
     ResizeFunction m_ResizeCallback {nullptr};
+    ModeFunction   m_ModeCallback {nullptr};
 
 public:
     static std::atomic_bool s_fExit;
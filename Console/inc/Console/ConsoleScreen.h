@@ -137,6 +137,11 @@ public:
         const ScreenBuffer& block, pos_t xoffset = 0, pos_t yoffset = 0) = 0;
 
     virtual bool Flush() = 0;
+
+    //output that terminal did not accept yet
+    virtual size_t OutputPending() const { return 0; }
+    virtual bool WaitOutput([[maybe_unused]] const std::chrono::milliseconds& waitTime) { return true; }
+    virtual void GetOutputStat(size_t& writes, size_t& bytes) const { writes = 0; bytes = 0; }
 };
 
 } //namespace _Console
@@ -73,6 +73,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define K_CONTROL   0x28000000 //control element id
 #define K_REFRESH   0x29000000 //refresh screen
 #define K_APP       0x2a000000 //application command
+#define K_PASTE     0x2b000000 //text pasted in terminal
 
 #define K_MOUSE     0x40000000 //mouse moved
 #define K_MOUSEKL   0x41000000 //left button
@@ -30,7 +30,9 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "Types.h"
 
 #include <vector>
+#include <string>
 #include <algorithm>
+#include <limits>
 
 
 namespace _Console
@@ -50,9 +52,67 @@ using cell_array = std::vector<cell_t>;
 //////////////////////////////////////////////////////////////////////////////
 class ScreenBuffer
 {
+    //changed columns of line, left > right for unchanged line
+    struct DirtySpan
+    {
+        size_t left {std::numeric_limits<size_t>::max()};
+        size_t right {};
+    };
+
     size_t      m_sizex{};
     size_t      m_sizey{};
     cell_array  m_buffer;
+    std::vector<DirtySpan> m_dirty;
+    bool        m_fDirty{};
+
+    void SetDirty(size_t left, size_t right, size_t y)
+    {
+        auto& span = m_dirty[y];
+        span.left = std::min(span.left, left);
+        span.right = std::max(span.right, right);
+        m_fDirty = true;
+    }
+
+    //one check for span, it is cut by line end
+    bool CheckSpan(size_t x, size_t y, size_t& len) const
+    {
+        if (0 == len)
+            return true;
+        if (x >= m_sizex || y >= m_sizey || len > m_sizex - x)
+        {
+            LOG(ERROR) << __FUNC__ << " x=" << x << " y=" << y << " len=" << len;
+            _assert(!"pos");
+            if (x >= m_sizex || y >= m_sizey)
+                return false;
+            len = m_sizex - x;
+        }
+        return true;
+    }
+
+    //writes cells made by func and marks changed ones
+    template<typename F>
+    bool PutSpan(size_t x, size_t y, size_t len, F makeCell)
+    {
+        if (!CheckSpan(x, y, len))
+            return false;
+
+        auto line = m_buffer.begin() + y * m_sizex + x;
+        size_t left = len;
+        size_t right = 0;
+        for (size_t i = 0; i < len; ++i)
+        {
+            cell_t c = makeCell(i, line[i]);
+            if (line[i] != c)
+            {
+                line[i] = c;
+                left = std::min(left, i);
+                right = i;
+            }
+        }
+        if (left <= right)
+            SetDirty(x + left, x + right, y);
+        return true;
+    }
 
 public:
     ScreenBuffer() = default;
@@ -60,7 +120,10 @@ public:
     : m_sizex{x}
     , m_sizey{y}
     , m_buffer(x * y)
-    {}
+    , m_dirty(y)
+    {
+        MarkDirty(0, 0, x - 1, y - 1);
+    }
 
     bool SetSize(size_t x = 0, size_t y = 0)
     {
@@ -74,15 +137,52 @@ public:
             }
             else
                 m_buffer.clear();
+            m_dirty.assign(y, DirtySpan{});
         }
         catch (...)
         {
             return false;
         }
+        MarkDirty(0, 0, x - 1, y - 1);
         return true;
     }
 
-    void Fill(cell_t fill) { std::for_each(m_buffer.begin(), m_buffer.end(), [fill](cell_t& cell) {cell = fill; }); }
+    void Fill(cell_t fill) 
+    { 
+        std::for_each(m_buffer.begin(), m_buffer.end(), [fill](cell_t& cell) {cell = fill; }); 
+        MarkDirty(0, 0, m_sizex - 1, m_sizey - 1);
+    }
+
+    //cells of block should be shown again
+    void MarkDirty(size_t left, size_t top, size_t right, size_t bottom)
+    {
+        if (0 == m_sizex || 0 == m_sizey)
+            return;
+        right = std::min(right, m_sizex - 1);
+        bottom = std::min(bottom, m_sizey - 1);
+        for (size_t y = top; y <= bottom; ++y)
+            if (left <= right)
+                SetDirty(left, right, y);
+    }
+
+    bool IsDirty() const { return m_fDirty; }
+
+    bool GetDirty(size_t y, size_t& left, size_t& right) const
+    {
+        if (!m_fDirty || y >= m_sizey || m_dirty[y].left > m_dirty[y].right)
+            return false;
+        left = m_dirty[y].left;
+        right = m_dirty[y].right;
+        return true;
+    }
+
+    void ClearDirty()
+    {
+        if (!m_fDirty)
+            return;
+        std::for_each(m_dirty.begin(), m_dirty.end(), [](DirtySpan& span) {span = DirtySpan{}; });
+        m_fDirty = false;
+    }
     
     void GetSize(size_t& x, size_t& y) const { x = m_sizex; y = m_sizey; }
     
@@ -109,9 +209,59 @@ public:
             _assert(!"pos");
             return false;
         }
-        m_buffer[x + y * m_sizex] = c;
+        cell_t& cell = m_buffer[x + y * m_sizex];
+        if (cell != c)
+        {
+            cell = c;
+            SetDirty(x, x, y);
+        }
         return true;
     }
+
+    bool WriteSpan(size_t x, size_t y, const std::u16string& text, const std::vector<color_t>& colors)
+    {
+        return PutSpan(x, y, std::min(text.size(), colors.size()),
+            [&](size_t i, cell_t) {return MAKE_CELL(0, colors[i], text[i]);});
+    }
+
+    bool WriteSpan(size_t x, size_t y, const std::u16string& text, color_t color)
+    {
+        return PutSpan(x, y, text.size(),
+            [&](size_t i, cell_t) {return MAKE_CELL(0, color, text[i]);});
+    }
+
+    bool FillSpan(size_t x, size_t y, size_t len, cell_t c)
+    {
+        return PutSpan(x, y, len, [c](size_t, cell_t) {return c;});
+    }
+
+    bool ColorSpan(size_t x, size_t y, const std::vector<color_t>& colors)
+    {
+        return PutSpan(x, y, colors.size(),
+            [&](size_t i, cell_t cell) {return MAKE_CELL(0, colors[i], cell);});
+    }
+
+    //hash of the line cells
+    size_t GetLineHash(size_t y) const
+    {
+        if (y >= m_sizey)
+        {
+            LOG(ERROR) << __FUNC__ << " y=" << y;
+            _assert(!"pos");
+            return 0;
+        }
+
+        //FNV-1a
+        size_t hash = static_cast<size_t>(14695981039346656037ull);
+        auto line = m_buffer.cbegin() + y * m_sizex;
+        for (size_t x = 0; x < m_sizex; ++x)
+        {
+            hash ^= line[x];
+            hash *= static_cast<size_t>(1099511628211ull);
+        }
+        return hash;
+    }
+
     bool SetColor(size_t x, size_t y, color_t c)
     {
         //LOG(DEBUG) << "set color x=" << x << " y=" << y << " c=" << std::hex << c << std::dec;
@@ -121,10 +271,16 @@ public:
             _assert(!"pos");
             return false;
         }
-        m_buffer[x + y * m_sizex] = MAKE_CELL(0, c, m_buffer[x + y * m_sizex]);
+        cell_t& cell = m_buffer[x + y * m_sizex];
+        if (cell != MAKE_CELL(0, c, cell))
+        {
+            cell = MAKE_CELL(0, c, cell);
+            SetDirty(x, x, y);
+        }
         return true;
     }
     
+    //terminal moves the same cells, so they are not marked as changed
     bool ScrollBlock(size_t left, size_t top, size_t right, size_t bottom, size_t n, scroll_t mode)
     {
         if (left >= m_sizex || right >= m_sizex || top >= m_sizey || bottom >= m_sizey)
@@ -0,0 +1,64 @@
+/*
+FreeBSD License
+
+Copyright (c) 2020-2021 vikonix: valeriy.kovalev.software@gmail.com
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include "Console/ConsoleInput.h"
+
+#include <list>
+#include <string>
+
+
+namespace _Console
+{
+
+using StepFunction = std::function<void(const std::string& name)>;
+
+//////////////////////////////////////////////////////////////////////////////
+//input without terminal, it replays script steps key by key
+class InputHeadless final : public ConsoleInput
+{
+    friend class Console;
+
+    struct ScriptStep
+    {
+        std::string name;
+        keybuff_t   keys;
+    };
+    std::list<ScriptStep> m_script;
+    //script begins before the first frame
+    bool            m_fIdle{true};
+    StepFunction    m_StepCallback{nullptr};
+
+public:
+    virtual bool Init() override { return true; }
+    virtual void Deinit() override {}
+    virtual bool InputPending(const std::chrono::milliseconds& waitTime = 500ms) override;
+
+    bool AddStep(const std::string& name, const keybuff_t& keys);
+};
+
+} //namespace _Console
@@ -0,0 +1,77 @@
+/*
+FreeBSD License
+
+Copyright (c) 2020-2021 vikonix: valeriy.kovalev.software@gmail.com
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include "Console/tty/ScreenTTY.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+
+namespace _Console
+{
+
+//output statistics of one script step
+struct HeadlessStep
+{
+    std::string name;
+    size_t      bytes{};
+    size_t      flushes{};
+    size_t      frames{};
+    std::chrono::microseconds time{};
+};
+
+#ifndef WIN32
+
+//////////////////////////////////////////////////////////////////////////////
+//screen without terminal, output is encoded as for terminal and only counted
+class ScreenHeadless final : public ScreenTTY
+{
+    size_t          m_flushes{};
+
+    std::vector<HeadlessStep> m_steps;
+    std::chrono::steady_clock::time_point m_stepStart;
+    bool            m_fStep{false};
+
+public:
+    ScreenHeadless() = default;
+    virtual ~ScreenHeadless() override { Deinit(); }
+
+    virtual bool Init() override;
+    virtual void Deinit() override;
+    virtual bool Flush() override;
+
+    //finish current step and start new one, empty name only finishes
+    void BeginStep(const std::string& name);
+    const std::vector<HeadlessStep>& GetSteps() const { return m_steps; }
+    const ScreenBuffer& GetScreen() const { return m_shadow; }
+};
+
+#endif //WIN32
+
+} //namespace _Console
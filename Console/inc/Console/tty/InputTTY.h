@@ -112,6 +112,7 @@ public:
 class InputTTY final: public ConsoleInput
 {
     inline static const size_t MaxInputLen {32};
+    inline static const size_t MaxPasteRead {0x1000};
     
     static std::atomic_bool s_fResize;
     static std::atomic_bool s_fCtrlC;
@@ -135,6 +136,8 @@ class InputTTY final: public ConsoleInput
     input_t         m_prevKey {0};
     bool            m_prevUp {false};
     std::chrono::steady_clock::time_point m_prevTime {};
+    //input read with paste after its end mark
+    std::string     m_unread;
 
 public:
     InputTTY() = default;
@@ -157,6 +160,7 @@ private:
     size_t          ReadConsole(std::string& str, size_t n);
     input_t         ProcessMouse(pos_t x, pos_t y, input_t k);
     void            ProcessInput(bool fMouse = false);
+    void            ProcessPaste(std::string&& buff);
     void            ProcessSignals();
 };
 
@@ -28,9 +28,12 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef WIN32
 
 #include "Console/ConsoleScreen.h"
+#include "Console/ScreenBuffer.h"
 #include "Console/tty/TermcapMap.h"
 
 #include <array>
+#include <chrono>
+#include <vector>
 
 #define COLOR_CHANGE(color) (((color) & TEXT_BRIGHT) | (((color) & TEXT_RED) >> 2) | ((color) & TEXT_GREEN) | (((color) & TEXT_BLUE) << 2))
 
@@ -53,7 +56,7 @@ enum acs_char : int
     ACS_CSQUARE         = '0'
 };
 
-class ScreenTTY final : public ConsoleScreen
+class ScreenTTY : public ConsoleScreen
 {
     friend class Console;
     
@@ -62,9 +65,14 @@ class ScreenTTY final : public ConsoleScreen
     const TermcapBuffer&  m_termcap {TermcapBuffer::getInstance()};
     
     int             m_stdout {-1};
+    int             m_stdoutFlags {-1};
     bool            m_fXTERMconsole{false};
     bool            m_256colors{false};
     std::string     m_OutBuff;
+    //output that terminal did not accept yet
+    std::vector<char> m_ring;
+    size_t          m_ringHead{};
+    size_t          m_ringSize{};
 
     struct CapString
     {
@@ -73,7 +81,28 @@ class ScreenTTY final : public ConsoleScreen
     };
     std::array<CapString, CAP_NUMBER> m_cap;
 
+    //precomputed sequences
+    std::array<std::string, 16> m_textColor;
+    std::array<std::string, 8>  m_fonColor;
+    std::vector<std::string>    m_rightN;
+    std::vector<std::string>    m_coord;
+    bool            m_ansiGoto{false};
+    //cursor is after the last column
+    bool            m_fWrap{false};
+    //terminal supports synchronized update mode
+    bool            m_fSyncUpdate{false};
+
+protected:
+    //what terminal shows now
+    ScreenBuffer    m_shadow;
+    //output is only counted and not written to terminal
+    bool            m_fMemory{false};
+
 public:
+    //output statistics
+    size_t          m_writeCalls{};
+    size_t          m_writeBytes{};
+
     ScreenTTY() = default;
     virtual ~ScreenTTY() override { Deinit(); }
 
@@ -87,14 +116,14 @@ public:
     virtual bool WriteStr(const std::u16string& str) override;
 
     virtual bool GotoXY(pos_t x, pos_t y) override;
-    virtual bool ClrScr() override {return _WriteStr(m_cap[S_ClrScr].str.c_str());}
+    virtual bool ClrScr() override;
     virtual bool SetCursor(cursor_t cursor) override;
     virtual bool SetTextAttr(color_t color) override;
 
-    virtual bool Left() override {return _WriteStr(m_cap[S_CursorLeft].str.c_str());}
-    virtual bool Right()override {return _WriteStr(m_cap[S_CursorRight].str.c_str());}
-    virtual bool Up()   override {return _WriteStr(m_cap[S_CursorUp].str.c_str());}
-    virtual bool Down() override {return _WriteStr(m_cap[S_CursorDown].str.c_str());}
+    virtual bool Left() override;
+    virtual bool Right()override;
+    virtual bool Up()   override;
+    virtual bool Down() override;
 
     virtual bool ScrollBlock(pos_t left, pos_t top, pos_t right, pos_t bottom,
         pos_t n, scroll_t mode, uint32_t* invalidate = NULL) override;
@@ -105,11 +134,28 @@ public:
 
     virtual bool Flush() override;
 
+    virtual size_t OutputPending() const override { return m_ringSize; }
+    virtual bool WaitOutput(const std::chrono::milliseconds& waitTime) override;
+    virtual void GetOutputStat(size_t& writes, size_t& bytes) const override
+        { writes = m_writeCalls; bytes = m_writeBytes; }
+
     bool GetScreenSize(pos_t& sizex, pos_t& sizey) const;
+    void ModeReport(int mode, int value);
 
 private:
+    bool IsOpen() const { return m_stdout > 0 || m_fMemory; }
     bool Resize(pos_t sizex, pos_t sizey);
+    void InvalidateShadow(pos_t left, pos_t top, pos_t right, pos_t bottom);
+    bool DetectScroll(pos_t top, pos_t bottom, const ScreenBuffer& block);
+    bool MoveCursor(ScreenCapType cap, pos_t dx, pos_t dy);
     
+    bool _GotoXY(pos_t x, pos_t y);
+    size_t GotoLen(pos_t x, pos_t y) const;
+    bool MoveX(pos_t from, pos_t to, size_t maxLen, std::string& move) const;
+
+    void PutOutput(const std::string& str);
+    bool DrainOutput();
+
     bool _WriteChar(char c);
     bool _WriteStr(const std::string& str);
     bool _WriteWChar(char16_t c);
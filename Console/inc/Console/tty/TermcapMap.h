@@ -52,6 +52,7 @@ enum ScreenCapType
     S_CursorBegStr,
     S_CursorLeft,
     S_CursorRight,
+    S_CursorRightN,
     S_CursorUp,
     S_CursorDown,
 
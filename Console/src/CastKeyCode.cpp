@@ -215,6 +215,9 @@ std::string ConsoleInput::CastKeyCode(input_t code)
         case K_APP:
             keyType = "App";
             break;
+        case K_PASTE:
+            keyType = "Paste";
+            break;
 
         default:
             if(code & K_USER)
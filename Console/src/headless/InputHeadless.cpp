@@ -0,0 +1,87 @@
+/*
+FreeBSD License
+
+Copyright (c) 2020-2021 vikonix: valeriy.kovalev.software@gmail.com
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "Console/headless/InputHeadless.h"
+
+
+namespace _Console
+{
+
+bool InputHeadless::AddStep(const std::string& name, const keybuff_t& keys)
+{
+    try
+    {
+        m_script.push_back({name, keys});
+    }
+    catch(...)
+    {
+        return false;
+    }
+    return true;
+}
+
+bool InputHeadless::InputPending([[maybe_unused]] const std::chrono::milliseconds& waitTime)
+{
+    if(!m_keyBuff.empty())
+        return true;
+
+    //pause after each key as user does, so application shows the frame
+    if(!m_fIdle)
+    {
+        m_fIdle = true;
+        return false;
+    }
+    m_fIdle = false;
+
+    if(m_script.empty())
+    {
+        //script is over
+        if(m_StepCallback)
+            m_StepCallback({});
+        s_fExit = true;
+        return false;
+    }
+
+    auto& step = m_script.front();
+    if(!step.name.empty())
+    {
+        if(m_StepCallback)
+            m_StepCallback(step.name);
+        step.name.clear();
+    }
+
+    if(!step.keys.empty())
+    {
+        m_keyBuff.push_back(step.keys.front());
+        step.keys.pop_front();
+    }
+    if(step.keys.empty())
+        m_script.pop_front();
+
+    return !m_keyBuff.empty();
+}
+
+} //namespace _Console
@@ -0,0 +1,85 @@
+/*
+FreeBSD License
+
+Copyright (c) 2020-2021 vikonix: valeriy.kovalev.software@gmail.com
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifndef WIN32
+#include "Console/headless/ScreenHeadless.h"
+
+
+namespace _Console
+{
+
+bool ScreenHeadless::Init()
+{
+    if(m_fMemory)
+        return true;
+
+    //terminal encoder writes to memory
+    m_fMemory = true;
+    if(m_sizex <= 0 || m_sizey <= 0)
+        SetSize(80, 25);
+    return ScreenTTY::Init();
+}
+
+void ScreenHeadless::Deinit()
+{
+    if(!m_fMemory)
+        return;
+
+    Flush();
+    m_fMemory = false;
+}
+
+bool ScreenHeadless::Flush()
+{
+    ++m_flushes;
+    return ScreenTTY::Flush();
+}
+
+void ScreenHeadless::BeginStep(const std::string& name)
+{
+    auto now = std::chrono::steady_clock::now();
+    if(m_fStep)
+    {
+        //step keeps counters from its begin
+        auto& step = m_steps.back();
+        step.bytes = m_writeBytes - step.bytes;
+        step.flushes = m_flushes - step.flushes;
+        step.frames = m_writeCalls - step.frames;
+        step.time = std::chrono::duration_cast<std::chrono::microseconds>(now - m_stepStart);
+        m_fStep = false;
+    }
+
+    if(!name.empty())
+    {
+        m_steps.push_back({name, m_writeBytes, m_flushes, m_writeCalls, {}});
+        m_stepStart = now;
+        m_fStep = true;
+    }
+}
+
+} //namespace _Console
+
+#endif //WIN32
@@ -55,6 +55,12 @@ std::atomic_bool ConsoleInput::s_fExit {false};
 std::atomic_bool InputTTY::s_fResize {false};
 std::atomic_bool InputTTY::s_fCtrlC {false};
 
+//bracketed paste marks
+static const std::string c_pasteBegin {"\x1b[200~"};
+static const std::string c_pasteEnd {"\x1b[201~"};
+//max time for receiving of all pasted text
+static const std::chrono::seconds c_pasteTime {10};
+
 
 //////////////////////////////////////////////////////////////////////////////
 bool InputTTY::LoadKeyCode()
@@ -282,6 +288,12 @@ bool InputTTY::InputPending(const std::chrono::milliseconds& WaitTime)
     if(GetInputLen())
         return true;
 
+    if(!m_unread.empty())
+    {
+        ProcessInput(false);
+        return 0 != GetInputLen();
+    }
+
     long secs  = 0;
     long usecs = WaitTime.count() * 1000;
 
@@ -324,6 +336,14 @@ bool InputTTY::InputPending(const std::chrono::milliseconds& WaitTime)
 //////////////////////////////////////////////////////////////////////////////
 size_t InputTTY::ReadConsole(std::string& str, size_t n)
 {
+    if(!m_unread.empty())
+    {
+        size_t len = std::min(n, m_unread.size());
+        str.append(m_unread, 0, len);
+        m_unread.erase(0, len);
+        return len;
+    }
+
     struct timeval wait;
     wait.tv_sec  = 0;
     wait.tv_usec = 100000;// 1/10 sec
@@ -335,7 +355,7 @@ size_t InputTTY::ReadConsole(std::string& str, size_t n)
     int s = select(m_stdin + 1, &Read_FD_Set, NULL, NULL, &wait);
     if(s > 0)
     {
-        std::string buff(MaxInputLen, 0);
+        std::string buff(n, 0);
 
         int rc = read(m_stdin, buff.data(), n);
         if(rc > 0)
@@ -471,6 +491,21 @@ void InputTTY::ProcessInput(bool fMouse)
         }
     }
 
+    if(iLen >= c_pasteBegin.size() && 0 == buff.compare(0, c_pasteBegin.size(), c_pasteBegin))
+    {
+        ProcessPaste(std::move(buff));
+        return;
+    }
+
+    if(iLen > 4 && buff[0] == 0x1b && buff[1] == '[' && buff[2] == '?' && buff.back() == 'y')
+    {
+        //terminal mode report "\x1b[?mode;value$y"
+        int mode, value;
+        if(2 == sscanf(buff.c_str(), "\x1b[?%d;%d$y", &mode, &value) && m_ModeCallback)
+            m_ModeCallback(mode, value);
+        return;
+    }
+
 #ifdef USE_MOUSE
 #ifdef OLD_MOUSE
     if(iLen >= 6 && buff[0] == 0x1b && buff[1] == 0x5b && buff[2] == 0x4d)//"\x1b[M"
@@ -702,6 +737,39 @@ void InputTTY::ProcessInput(bool fMouse)
 }
 
 
+void InputTTY::ProcessPaste(std::string&& buff)
+{
+    //all text till end mark is one paste event
+    buff.erase(0, c_pasteBegin.size());
+
+    auto deadline = std::chrono::steady_clock::now() + c_pasteTime;
+    size_t from = 0;
+    size_t end;
+    while((end = buff.find(c_pasteEnd, from)) == std::string::npos)
+    {
+        if(std::chrono::steady_clock::now() >= deadline)
+        {
+            LOG(WARNING) << "Paste end not found size=" << buff.size();
+            break;
+        }
+
+        //end mark may begin in the previous part
+        from = buff.size() >= c_pasteEnd.size() ? buff.size() - c_pasteEnd.size() + 1 : 0;
+        ReadConsole(buff, MaxPasteRead);
+    }
+
+    if(end != std::string::npos)
+    {
+        //following input is decoded as keys
+        m_unread.insert(0, buff, end + c_pasteEnd.size());
+        buff.resize(end);
+    }
+
+    //LOG(DEBUG) << "Paste size=" << buff.size();
+    PutPaste(utf8::utf8to16(utf8::replace_invalid(buff)));
+}
+
+
 //////////////////////////////////////////////////////////////////////////////
 void InputTTY::ProcessSignals()
 {
@@ -32,13 +32,17 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "Console/ScreenBuffer.h"
 
 #include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
 #include <unistd.h>
+#include <sys/uio.h>
 #include <pwd.h>
 #include <term.h>
 #include <sys/ioctl.h>
 
 #include <iomanip>
 #include <filesystem>
+#include <algorithm>
 
 template<typename T>
 inline T IGUR(T func) { return func; }  /* Ignore GCC Unused Result */
@@ -48,13 +52,27 @@ using namespace _Utils;
 namespace _Console
 {
 
+//cell that never matches cell from screen buffer
+static const cell_t c_invalidCell {CATTR_MASK};
+//max unchanged cells rewritten instead of cursor positioning
+static const pos_t c_maxGap {4};
+//min lines that should be moved by terminal for using scroll
+static const pos_t c_minScrollGain {3};
+//DECSET mode for synchronized update
+static const int c_syncMode {2026};
+static const std::string c_syncBegin {"\x1b[?2026h"};
+static const std::string c_syncEnd {"\x1b[?2026l"};
+//smaller frames are written at once
+static const size_t c_syncFrameSize {512};
+
 bool ScreenTTY::Init()
 {
     if(m_stdout > 0)
         return true;
 
     //get file handler
-    m_stdout = fileno (stdout);
+    if(!m_fMemory)
+        m_stdout = fileno (stdout);
 
     //load termcap
     for(const auto& cap: g_screenCap)
@@ -81,7 +99,11 @@ bool ScreenTTY::Init()
         }
     }
     
-    GetScreenSize(m_sizex, m_sizey);
+    if(!m_fMemory)
+        GetScreenSize(m_sizex, m_sizey);
+    SetSize(m_sizex, m_sizey);
+    m_posx = -1;
+    m_posy = -1;
 
     char* term = getenv("TERM");
     if (term)
@@ -99,12 +121,26 @@ bool ScreenTTY::Init()
         if(!m_cap[i].str.empty())
             LOG(DEBUG) << " Cap[" << i << "][" << m_cap[i].id << "]" << CastEscString(m_cap[i].str);
 
-    //save parameters and use alternative screen buffer
-    std::string cmd { "\0337\x1b[?47h"};
-    IGUR(write(m_stdout, cmd.c_str(), cmd.size()));
+    if(!m_fMemory)
+    {
+        //save parameters and use alternative screen buffer
+        std::string cmd { "\0337\x1b[?47h"};
+        IGUR(write(m_stdout, cmd.c_str(), cmd.size()));
+
+        //output must not block input treatment on slow terminal
+        m_stdoutFlags = fcntl(m_stdout, F_GETFL);
+        if(m_stdoutFlags != -1)
+            fcntl(m_stdout, F_SETFL, m_stdoutFlags | O_NONBLOCK);
+    }
 
+    //bracketed paste
     [[maybe_unused]] bool rc = _WriteStr(m_cap[S_AltCharEnable].str)
-        && Flush();
+        && _WriteStr("\x1b[?2004h");
+    if(m_fXTERMconsole)
+        //request synchronized update mode state (DECRQM),
+        //frames are not wrapped until terminal reports support
+        rc = _WriteStr("\x1b[?" + std::to_string(c_syncMode) + "$p");
+    rc = Flush();
 
     if(term && !strncmp(term, "vt100", 5))
     {
@@ -125,6 +161,45 @@ bool ScreenTTY::Init()
             m_cap[S_Normal].str.resize(len - 4);
     }
 
+    //precompute color sequences
+    for(size_t i = 0; i < m_textColor.size(); ++i)
+    {
+        int text = COLOR_CHANGE(TEXT_COLOR(i));
+        if(m_256colors)
+        {
+            if(0 != (i & TEXT_BRIGHT))
+                text += 8;
+            m_textColor[i] = tgoto("\x1b[38;5;%dm", 0, text);
+        }
+        else if(!m_cap[S_SetTextColor].str.empty())
+            m_textColor[i] = tgoto(m_cap[S_SetTextColor].str.c_str(), 0, text);
+    }
+    for(size_t i = 0; i < m_fonColor.size(); ++i)
+    {
+        if(m_256colors)
+            m_fonColor[i] = tgoto("\x1b[48;5;%dm", 0, COLOR_CHANGE(i));
+        else if(!m_cap[S_SetFonColor].str.empty())
+            m_fonColor[i] = tgoto(m_cap[S_SetFonColor].str.c_str(), 0, COLOR_CHANGE(i));
+    }
+
+    //precompute cursor movement
+    if(!m_cap[S_CursorRightN].str.empty())
+    {
+        m_rightN.resize(MAX_COORD + 1);
+        for(int i = 1; i <= MAX_COORD; ++i)
+            m_rightN[i] = tgoto(m_cap[S_CursorRightN].str.c_str(), 0, i);
+    }
+
+    if(!m_cap[S_GotoXY].str.empty())
+    {
+        //the most of terminals use ANSI positioning
+        m_ansiGoto = std::string(tgoto(m_cap[S_GotoXY].str.c_str(), 0, 0)) == "\x1b[1;1H"
+                  && std::string(tgoto(m_cap[S_GotoXY].str.c_str(), 12, 34)) == "\x1b[35;13H";
+        if(m_ansiGoto)
+            for(int i = 0; i <= MAX_COORD; ++i)
+                m_coord.push_back(std::to_string(i + 1));
+    }
+
   return true;
 }
 
@@ -134,6 +209,13 @@ void ScreenTTY::Deinit()
     if(m_stdout <= 0)
         return;
 
+    Flush();
+    if(m_stdoutFlags != -1)
+        fcntl(m_stdout, F_SETFL, m_stdoutFlags);
+    m_stdoutFlags = -1;
+    DrainOutput();
+    LOG(DEBUG) << "output writes=" << m_writeCalls << " bytes=" << m_writeBytes;
+
     std::string param = m_cap[S_TermReset].str;
     if(!param.empty())
     {
@@ -141,7 +223,7 @@ void ScreenTTY::Deinit()
     }
 
     //use normal screen buffer and restore parameters
-    param = "\x1b[?47l\0338\x1b[0m";
+    param = "\x1b[?2004l\x1b[?47l\0338\x1b[0m";
     IGUR(write(m_stdout, param.c_str(), param.size()));
 
     //set default foreground/background
@@ -219,31 +301,162 @@ bool ScreenTTY::GetScreenSize(pos_t& sizex, pos_t& sizey) const
 
 bool ScreenTTY::WriteConsoleTitle(const std::string& title)
 {
-    if(m_stdout <= 0)
+    if(!IsOpen())
         return false;
 
-    //for XTERM
+    //for XTERM, title is sent with next frame
+    bool rc = true;
     if(m_fXTERMconsole)
-    {
-        std::string str {"\x1b]0;" + title + "\7"};
-        IGUR(write(m_stdout, str.c_str(), str.size()));
-    }
+        rc = _WriteStr("\x1b]0;" + title + "\7");
 
-    return true;
+    return rc;
 }
 
 
 bool ScreenTTY::GotoXY(pos_t x, pos_t y)
 {
-    if(m_stdout <= 0)
+    if(!IsOpen())
         return false;
     if(m_cap[S_GotoXY].str.empty())
         return false;
 
+    if(m_fWrap || m_posx < 0 || m_posy < 0 || (y != m_posy && y != m_posy + 1))
+        return _GotoXY(x, y);
+    if(x == m_posx && y == m_posy)
+        return true;
+
+    //use relative movement if it is shorter
+    size_t maxLen = GotoLen(x, y) - 1;
+    std::string move;
+    bool fMove = y == m_posy && MoveX(m_posx, x, maxLen, move);
+
+    //move from line begin, because LF may also move cursor there
+    const std::string& cr = m_cap[S_CursorBegStr].str;
+    const std::string& down = m_cap[S_CursorDown].str;
+    std::string moveCR {cr};
+    if(y != m_posy)
+        moveCR += down;
+    if(!cr.empty() && (y == m_posy || !down.empty())
+        && moveCR.size() <= maxLen && MoveX(0, x, maxLen - moveCR.size(), moveCR)
+        && (!fMove || moveCR.size() < move.size()))
+    {
+        move = moveCR;
+        fMove = true;
+    }
+
+    if(!fMove)
+        return _GotoXY(x, y);
+
     m_posx = x;
     m_posy = y;
+    return _WriteStr(move);
+}
+
+
+bool ScreenTTY::_GotoXY(pos_t x, pos_t y)
+{
+    if(m_cap[S_GotoXY].str.empty())
+        return false;
+
+    m_posx = x;
+    m_posy = y;
+    m_fWrap = false;
+
+    if(!m_ansiGoto)
+        return _WriteStr(tgoto(m_cap[S_GotoXY].str.c_str(), x, y));
+
+    m_OutBuff += "\x1b[";
+    m_OutBuff += m_coord[y];
+    m_OutBuff += ';';
+    m_OutBuff += m_coord[x];
+    m_OutBuff += 'H';
+
+    return true;
+}
+
+
+size_t ScreenTTY::GotoLen(pos_t x, pos_t y) const
+{
+    if(m_ansiGoto)
+        return 4 + m_coord[x].size() + m_coord[y].size();
+    return strlen(tgoto(m_cap[S_GotoXY].str.c_str(), x, y));
+}
 
-    return _WriteStr(tgoto(m_cap[S_GotoXY].str.c_str(), x, y));
+
+bool ScreenTTY::MoveX(pos_t from, pos_t to, size_t maxLen, std::string& move) const
+{
+    const std::string& step = to > from ? m_cap[S_CursorRight].str : m_cap[S_CursorLeft].str;
+    size_t n = static_cast<size_t>(to > from ? to - from : from - to);
+    if(n == 0)
+        return true;
+
+    if(to > from && n < m_rightN.size() && (step.empty() || m_rightN[n].size() < step.size() * n))
+    {
+        if(m_rightN[n].size() > maxLen)
+            return false;
+        move += m_rightN[n];
+        return true;
+    }
+
+    if(step.empty() || step.size() * n > maxLen)
+        return false;
+
+    for(size_t i = 0; i < n; ++i)
+        move += step;
+    return true;
+}
+
+
+bool ScreenTTY::MoveCursor(ScreenCapType cap, pos_t dx, pos_t dy)
+{
+    if(m_cap[cap].str.empty())
+        return false;
+
+    if(m_fWrap || m_posx < 0 || m_posy < 0)
+    {
+        m_posx = -1;
+        m_posy = -1;
+        return _WriteStr(m_cap[cap].str);
+    }
+
+    m_posx = static_cast<pos_t>(std::clamp(m_posx + dx, 0, m_sizex - 1));
+    m_posy = static_cast<pos_t>(std::clamp(m_posy + dy, 0, m_sizey - 1));
+
+    return _WriteStr(m_cap[cap].str);
+}
+
+
+bool ScreenTTY::Left()
+{
+    return MoveCursor(S_CursorLeft, -1, 0);
+}
+
+
+bool ScreenTTY::Right()
+{
+    return MoveCursor(S_CursorRight, 1, 0);
+}
+
+
+bool ScreenTTY::Up()
+{
+    return MoveCursor(S_CursorUp, 0, -1);
+}
+
+
+bool ScreenTTY::Down()
+{
+    return MoveCursor(S_CursorDown, 0, 1);
+}
+
+
+bool ScreenTTY::ClrScr()
+{
+    //filling color depends on terminal
+    InvalidateShadow(0, 0, m_sizex - 1, m_sizey - 1);
+    m_posx = -1;
+    m_posy = -1;
+    return _WriteStr(m_cap[S_ClrScr].str);
 }
 
 
@@ -272,11 +485,7 @@ bool ScreenTTY::SetCursor(cursor_t cursor)
     }
     
     m_cursor = cursor;
-    
-    int rc = _WriteStr(std::string{cap})
-    && Flush();
-    
-    return rc;
+    return _WriteStr(std::string{cap});
 }
 
 
@@ -284,37 +493,29 @@ bool ScreenTTY::SetTextAttr(color_t color)
 {
     if(m_color == color)
         return true;
-    if(m_stdout <= 0)
+    if(!IsOpen())
         return false;
 
     //LOG(DEBUG) << "SetTextAttr " << std::hex << color << std::dec;
     bool rc = true;
+    bool reset = false;
 
     if((color & TEXT_BRIGHT) != (m_color & TEXT_BRIGHT))
     {
         if((color & TEXT_BRIGHT) == 0)
+        {
+            //normal mode also resets colors
             rc = _WriteStr(m_cap[S_Normal].str);
+            reset = true;
+        }
         else
             rc = _WriteStr(m_cap[S_ColorBold].str);
     }
     
-    if(TEXT_COLOR(color) != TEXT_COLOR(m_color) || FON_COLOR(color) != FON_COLOR(m_color))
+    if(reset || TEXT_COLOR(color) != TEXT_COLOR(m_color) || FON_COLOR(color) != FON_COLOR(m_color))
     {
-        if(!m_256colors)
-        {
-            if(!m_cap[S_SetTextColor].str.empty())
-                rc = _WriteStr(tgoto(m_cap[S_SetTextColor].str.c_str(), 0, COLOR_CHANGE(TEXT_COLOR(color))));
-            if(!m_cap[S_SetFonColor].str.empty())
-                rc = _WriteStr(tgoto(m_cap[S_SetFonColor].str.c_str(), 0, COLOR_CHANGE(FON_COLOR(color))));
-        }
-        else
-        {
-            int text = COLOR_CHANGE(TEXT_COLOR(color));
-            if(0 != (color & TEXT_BRIGHT))
-                text += 8;
-            rc = _WriteStr(tgoto("\x1b[38;5;%dm", 0, text));
-            rc = _WriteStr(tgoto("\x1b[48;5;%dm", 0, COLOR_CHANGE(FON_COLOR(color))));
-        }
+        rc = _WriteStr(m_textColor[color & (TEXT_BRIGHT | COLOR_MASK)])
+          && _WriteStr(m_fonColor[FON_COLOR(color)]);
     }
 
     m_color = color;
@@ -324,41 +525,133 @@ bool ScreenTTY::SetTextAttr(color_t color)
 
 bool ScreenTTY::Flush()
 {
-    if(m_stdout <= 0)
+    if(!IsOpen())
         return false;
-    if(m_OutBuff.empty())
-        return true;
 
-    int rc;
-    while(-1 == (rc = write(m_stdout, m_OutBuff.c_str(), m_OutBuff.size())))
+    if(!m_OutBuff.empty())
+    {
+        //LOG(DEBUG) << "Flush buff size=" << m_OutBuff.size() << " pending=" << m_ringSize;
+        //LOG(DEBUG) << CastEscString(m_OutBuff);
+        if(m_fSyncUpdate && m_OutBuff.size() >= c_syncFrameSize)
+        {
+            //terminal shows the whole frame at once
+            PutOutput(c_syncBegin);
+            PutOutput(m_OutBuff);
+            PutOutput(c_syncEnd);
+        }
+        else
+            PutOutput(m_OutBuff);
+        m_OutBuff.clear();
+    }
+
+    return DrainOutput();
+}
+
+
+void ScreenTTY::PutOutput(const std::string& str)
+{
+    size_t size = m_ringSize + str.size();
+    if(size > m_ring.size())
     {
-        if(errno == EINTR)
-            continue;
+        //grow buffer and move pending data to the begin
+        std::vector<char> ring(std::max(std::max(m_ring.size() * 2, OUTBUFF_SIZE), size));
+        size_t n = std::min(m_ringSize, m_ring.size() - m_ringHead);
+        std::copy_n(m_ring.begin() + m_ringHead, n, ring.begin());
+        std::copy_n(m_ring.begin(), m_ringSize - n, ring.begin() + n);
+        m_ring.swap(ring);
+        m_ringHead = 0;
+    }
 
-        if(errno == EAGAIN)
+    size_t tail = (m_ringHead + m_ringSize) % m_ring.size();
+    size_t n = std::min(str.size(), m_ring.size() - tail);
+    std::copy_n(str.begin(), n, m_ring.begin() + tail);
+    std::copy_n(str.begin() + n, str.size() - n, m_ring.begin());
+    m_ringSize = size;
+}
+
+
+bool ScreenTTY::DrainOutput()
+{
+    if(m_fMemory)
+    {
+        if(m_ringSize)
         {
-            sleep(1);
-            continue;
+            ++m_writeCalls;
+            m_writeBytes += m_ringSize;
+            m_ringSize = 0;
         }
+        m_ringHead = 0;
+        return true;
+    }
 
-        break;
+    while(m_ringSize)
+    {
+        size_t n = std::min(m_ringSize, m_ring.size() - m_ringHead);
+        struct iovec iov[2];
+        iov[0].iov_base = m_ring.data() + m_ringHead;
+        iov[0].iov_len  = n;
+        iov[1].iov_base = m_ring.data();
+        iov[1].iov_len  = m_ringSize - n;
+
+        ssize_t rc = writev(m_stdout, iov, iov[1].iov_len ? 2 : 1);
+        if(rc < 0)
+        {
+            if(errno == EINTR)
+                continue;
+            if(errno == EAGAIN || errno == EWOULDBLOCK)
+                //terminal is busy, rest of output will be written later
+                return true;
+
+            LOG(ERROR) << "output error=" << errno << " lost=" << m_ringSize;
+            m_ringHead = 0;
+            m_ringSize = 0;
+            return false;
+        }
+
+        ++m_writeCalls;
+        m_writeBytes += static_cast<size_t>(rc);
+        m_ringHead = (m_ringHead + static_cast<size_t>(rc)) % m_ring.size();
+        m_ringSize -= static_cast<size_t>(rc);
     }
 
-    //LOG(DEBUG) << "Flush buff size=" << m_OutBuff.size() << "->" << rc;
-    //LOG(DEBUG) << CastEscString(m_OutBuff);
-    m_OutBuff.clear();
+    m_ringHead = 0;
+    return true;
+}
+
 
-    return rc > 0;
+void ScreenTTY::ModeReport(int mode, int value)
+{
+    LOG(DEBUG) << "mode=" << mode << " value=" << value;
+
+    //1 - set, 2 - reset, 0 - not recognized, 4 - permanently reset
+    if(mode == c_syncMode)
+        m_fSyncUpdate = value == 1 || value == 2;
+}
+
+
+bool ScreenTTY::WaitOutput(const std::chrono::milliseconds& waitTime)
+{
+    if(!IsOpen())
+        return false;
+    if(!m_ringSize)
+        return true;
+
+    struct pollfd fd;
+    fd.fd      = m_stdout;
+    fd.events  = POLLOUT;
+    fd.revents = 0;
+
+    int rc = poll(&fd, 1, static_cast<int>(waitTime.count()));
+    if(rc > 0)
+        return DrainOutput();
+
+    return rc == 0 || errno == EINTR;
 }
 
 
 bool ScreenTTY::_WriteStr(const std::string& str)
 {
     m_OutBuff += str;
-    
-    if(m_OutBuff.size() >= OUTBUFF_SIZE)
-        return Flush();
-
     return true;
 }
 
@@ -366,10 +659,6 @@ bool ScreenTTY::_WriteStr(const std::string& str)
 bool ScreenTTY::_WriteChar(char c)
 {
     m_OutBuff += c;
-
-    if(m_OutBuff.size() >= OUTBUFF_SIZE)
-        return Flush();
-
     return true;
 }
 
@@ -380,7 +669,11 @@ bool ScreenTTY::_WriteWChar(char16_t wc)
 
     if(wc == 0)
         return true;
-    else if(wc < ACS_MAX)
+
+    if(m_posx >= 0 && m_posx < m_sizex && m_posy >= 0 && m_posy < m_sizey)
+        m_shadow.SetCell(m_posx, m_posy, MAKE_CELL(0, m_color, wc));
+
+    if(wc < ACS_MAX)
     {
         //Alt char set
         std::string str;
@@ -401,8 +694,10 @@ bool ScreenTTY::_WriteWChar(char16_t wc)
         }
     }
 
+    m_fWrap = false;
     if(++m_posx >= m_sizex)
     {
+        m_fWrap = true;
         m_posx = 0;
         if(m_posy < m_sizey - 1)
             ++m_posy;
@@ -417,13 +712,25 @@ bool ScreenTTY::SetSize(pos_t sizex, pos_t sizey)
     m_sizex = sizex;
     m_sizey = sizey;
 
+    //terminal content is unknown after resizing
+    m_shadow.SetSize(m_sizex, m_sizey);
+    m_shadow.Fill(c_invalidCell);
+
     return true;
 }
 
 
+void ScreenTTY::InvalidateShadow(pos_t left, pos_t top, pos_t right, pos_t bottom)
+{
+    for(pos_t y = top; y <= bottom; ++y)
+        for(pos_t x = left; x <= right; ++x)
+            m_shadow.SetCell(x, y, c_invalidCell);
+}
+
+
 bool ScreenTTY::WriteChar(char16_t c)
 {
-    if(m_stdout <= 0)
+    if(!IsOpen())
         return false;
 
     return _WriteWChar(c);
@@ -432,7 +739,7 @@ bool ScreenTTY::WriteChar(char16_t c)
 
 bool ScreenTTY::WriteStr(const std::u16string& str)
 {
-    if(m_stdout <= 0)
+    if(!IsOpen())
         return false;
 
     for(auto c : str)
@@ -460,7 +767,7 @@ bool ScreenTTY::Beep()
 
 bool ScreenTTY::WriteLastChar(char16_t prevC, char16_t lastC)
 {
-    if(m_stdout <= 0)
+    if(!IsOpen())
         return false;
 
     //LOG(DEBUG) << "WriteLastChar " << std::hex << prevC << " " << lastC << std::dec;
@@ -476,6 +783,7 @@ bool ScreenTTY::WriteLastChar(char16_t prevC, char16_t lastC)
     rc = WriteChar(prevC)
     && _WriteStr(m_cap[S_EInsertMode].str);
 
+    m_shadow.SetCell(m_sizex - 1, m_sizey - 1, MAKE_CELL(0, m_color, lastC));
     return rc;
 }
 
@@ -500,7 +808,7 @@ bool ScreenTTY::ScrollBlock(pos_t left, pos_t top, pos_t right, pos_t bottom,
             //fix up/down scroll region
             rc = _WriteStr(tgoto(cap.c_str(), bottom, top));
 
-        rc = GotoXY(0, top);
+        rc = _GotoXY(0, top);
         if(!m_cap[S_DeleteLN].str.empty())
             rc = _WriteStr(tgoto(m_cap[S_DeleteLN].str.c_str(), 0, n));
         else
@@ -512,13 +820,21 @@ bool ScreenTTY::ScrollBlock(pos_t left, pos_t top, pos_t right, pos_t bottom,
         else
         {
             //if fix impossible then insert bottom lines
-            rc = GotoXY(0, bottom);
+            rc = _GotoXY(0, bottom);
             if(!m_cap[S_InsertLN].str.empty())
                 rc = _WriteStr(tgoto(m_cap[S_InsertLN].str.c_str(), 0, n));
             else
                 for(pos_t i = 0; i < n; ++i)
                     rc = _WriteStr(m_cap[S_InsertL].str.c_str());
         }
+
+        if(!cap.empty())
+        {
+            m_shadow.ScrollBlock(0, top, m_sizex - 1, bottom, n, mode);
+            InvalidateShadow(0, bottom - n + 1, m_sizex - 1, bottom);
+        }
+        else
+            InvalidateShadow(0, top, m_sizex - 1, m_sizey - 1);
         break;
 
     case scroll_t::SCROLL_DOWN:
@@ -534,7 +850,7 @@ bool ScreenTTY::ScrollBlock(pos_t left, pos_t top, pos_t right, pos_t bottom,
         else
         {
             //if fix impossible then delete bottom lines before
-            rc = GotoXY(0, bottom);
+            rc = _GotoXY(0, bottom);
             if(!m_cap[S_DeleteLN].str.empty())
                 rc = _WriteStr(tgoto(m_cap[S_DeleteLN].str.c_str(), 0, n));
             else
@@ -542,7 +858,7 @@ bool ScreenTTY::ScrollBlock(pos_t left, pos_t top, pos_t right, pos_t bottom,
                     rc = _WriteStr(m_cap[S_DeleteL].str.c_str());
         }
 
-        rc = GotoXY(0, top);
+        rc = _GotoXY(0, top);
         if(!m_cap[S_InsertLN].str.empty())
             rc = _WriteStr(tgoto(m_cap[S_InsertLN].str.c_str(), 0, n));
         else
@@ -550,7 +866,13 @@ bool ScreenTTY::ScrollBlock(pos_t left, pos_t top, pos_t right, pos_t bottom,
                 rc = _WriteStr(m_cap[S_InsertL].str.c_str());
 
         if(!cap.empty())
+        {
             rc = _WriteStr(tgoto(cap.c_str(), m_sizey - 1, 0));
+            m_shadow.ScrollBlock(0, top, m_sizex - 1, bottom, n, mode);
+            InvalidateShadow(0, top, m_sizex - 1, top + n - 1);
+        }
+        else
+            InvalidateShadow(0, top, m_sizex - 1, m_sizey - 1);
         break;
 
     case scroll_t::SCROLL_LEFT:
@@ -565,7 +887,7 @@ bool ScreenTTY::ScrollBlock(pos_t left, pos_t top, pos_t right, pos_t bottom,
 
         for(pos_t i = top; i <= bottom; ++i)
         {
-            rc = GotoXY(left, i);
+            rc = _GotoXY(left, i);
 
             if(n > 1 && !m_cap[S_DelCharN].str.empty())
                 rc = _WriteStr(tgoto(m_cap[S_DelCharN].str.c_str(), 0, n));
@@ -574,7 +896,7 @@ bool ScreenTTY::ScrollBlock(pos_t left, pos_t top, pos_t right, pos_t bottom,
                     rc = _WriteStr(m_cap[S_DelChar].str.c_str());
 
             //now insert right chars
-            rc = GotoXY(right - n + 1, i);
+            rc = _GotoXY(right - n + 1, i);
 
             if(!m_cap[S_InsertMode].str.empty())
             {
@@ -587,6 +909,9 @@ bool ScreenTTY::ScrollBlock(pos_t left, pos_t top, pos_t right, pos_t bottom,
         }
 
         rc = _WriteStr(m_cap[S_EInsertMode].str.c_str());
+
+        m_shadow.ScrollBlock(left, top, right, bottom, n, mode);
+        InvalidateShadow(right - n + 1, top, right, bottom);
         break;
     }
 
@@ -603,7 +928,7 @@ bool ScreenTTY::ScrollBlock(pos_t left, pos_t top, pos_t right, pos_t bottom,
         for(pos_t i = top; i <= bottom; ++i)
         {
             //before delete right chars
-            rc = GotoXY(right - n, i);
+            rc = _GotoXY(right - n, i);
 
             if(n > 1 && !m_cap[S_DelCharN].str.empty())
                 rc = _WriteStr(tgoto(m_cap[S_DelCharN].str.c_str(), 0, n));
@@ -611,7 +936,7 @@ bool ScreenTTY::ScrollBlock(pos_t left, pos_t top, pos_t right, pos_t bottom,
                 for(pos_t j = 0; j < n; ++j)
                     rc = _WriteStr(m_cap[S_DelChar].str.c_str());
 
-            rc = GotoXY(left, i);
+            rc = _GotoXY(left, i);
 
             if(!m_cap[S_InsertMode].str.empty())
             {
@@ -624,6 +949,9 @@ bool ScreenTTY::ScrollBlock(pos_t left, pos_t top, pos_t right, pos_t bottom,
         }
 
         rc = _WriteStr(m_cap[S_EInsertMode].str.c_str());
+
+        m_shadow.ScrollBlock(left, top, right, bottom, n, mode);
+        InvalidateShadow(left, top, left + n - 1, bottom);
         break;
     }
 
@@ -631,55 +959,162 @@ bool ScreenTTY::ScrollBlock(pos_t left, pos_t top, pos_t right, pos_t bottom,
         return false;
     }
 
+    //cursor position is unknown after scroll region changing
+    m_posx = -1;
+    m_posy = -1;
     return rc;
 }
 
+bool ScreenTTY::DetectScroll(pos_t top, pos_t bottom, const ScreenBuffer& block)
+{
+    //compare lines of new block with lines that terminal shows
+    std::vector<size_t> oldHash;
+    std::vector<size_t> newHash;
+    for(pos_t y = top; y <= bottom; ++y)
+    {
+        oldHash.push_back(m_shadow.GetLineHash(y));
+        newHash.push_back(block.GetLineHash(y));
+    }
+
+    //lines on their places are not scrolled
+    pos_t first = 0;
+    pos_t last = bottom - top;
+    while(first <= last && oldHash[first] == newHash[first])
+        ++first;
+    while(last > first && oldHash[last] == newHash[last])
+        --last;
+
+    //find shift that moves max number of lines,
+    //lines that are on their places now and will be moved are lost
+    auto gain = [&](pos_t i, pos_t from) -> pos_t {
+        bool inPlace = newHash[i] == oldHash[i];
+        bool moved = from >= first && from <= last && newHash[i] == oldHash[from];
+        return (moved && !inPlace) ? 1 : (!moved && inPlace) ? -1 : 0;
+    };
+
+    pos_t size = last - first + 1;
+    pos_t bestShift {};
+    pos_t bestGain {};
+    for(pos_t n = 1; n < size - 1; ++n)
+    {
+        pos_t up {};
+        pos_t down {};
+        for(pos_t i = first; i <= last; ++i)
+        {
+            up += gain(i, i + n);
+            down += gain(i, i - n);
+        }
+
+        if(up > bestGain)
+        {
+            bestGain = up;
+            bestShift = n;
+        }
+        if(down > bestGain)
+        {
+            bestGain = down;
+            bestShift = -n;
+        }
+    }
+
+    if(bestGain < c_minScrollGain)
+        return false;
+
+    //LOG(DEBUG) << "scroll detected t=" << top + first << " b=" << top + last << " n=" << bestShift << " gain=" << bestGain;
+    if(bestShift > 0)
+        return ScrollBlock(0, top + first, m_sizex - 1, top + last, bestShift, scroll_t::SCROLL_UP);
+    else
+        return ScrollBlock(0, top + first, m_sizex - 1, top + last, -bestShift, scroll_t::SCROLL_DOWN);
+}
+
 bool ScreenTTY::WriteBlock(
     pos_t left, pos_t top, pos_t right, pos_t bottom,
     const ScreenBuffer& block, pos_t xoffset, pos_t yoffset)
 {
-    bool rc = false;
+    bool rc = true;
 
     //LOG(DEBUG) << "WriteBlock l=" << left << " t=" << top << " r=" << right << " b=" << bottom;
+
+    size_t blockx, blocky;
+    block.GetSize(blockx, blocky);
+    if(xoffset == left && yoffset == top
+        && blockx == static_cast<size_t>(m_sizex) && blocky == static_cast<size_t>(m_sizey)
+        && bottom - top >= c_minScrollGain && !m_cap[S_SetScroll].str.empty()
+        && DetectScroll(top, bottom, block))
+    {
+        //terminal moved whole lines, all other cells of scrolled lines should be checked
+        left = 0;
+        right = m_sizex - 1;
+        xoffset = 0;
+    }
     
     bool fLast {false};
     if(right == m_sizex - 1 && bottom == m_sizey - 1)
         fLast = 1;
 
-    color_t color {0};
+    //write only cells changed from the last output
     pos_t sizex = right - left + 1;
     pos_t sizey = bottom - top + 1;
     for(pos_t y = 0; y < sizey; ++y)
     {
-        GotoXY(left, top + y);
-        for(pos_t x = 0; x < sizex; ++x)
+        pos_t endx = sizex;
+        if(fLast && y == sizey - 1)
+            endx = std::max(0, sizex - 2);
+
+        pos_t py = top + y;
+        for(pos_t x = 0; x < endx; ++x)
         {
             cell_t c = block.GetCell(xoffset + x, yoffset + y);
-            color_t a = GET_CCOLOR(c);
+            pos_t px = left + x;
+            if(c == m_shadow.GetCell(px, py))
+                continue;
+
             char16_t ch = GET_CTEXT(c);
-            if(color != a)
+            if(ch == 0)
+            {
+                //nothing to print
+                m_shadow.SetCell(px, py, c);
+                continue;
+            }
+
+            if(m_fWrap || m_posy != py || m_posx != px)
             {
-                //LOG(DEBUG) << "x=" << x << " y=" << y << " a=" << std::hex << a << std::dec;
-                rc = SetTextAttr(a);
-                color = a;
+                //rewrite short gap of same color instead of cursor positioning
+                bool fGap = m_posy == py && m_posx > 0 && m_posx >= left && m_posx < px && px - m_posx <= c_maxGap;
+                for(pos_t i = m_posx; fGap && i < px; ++i)
+                {
+                    cell_t g = m_shadow.GetCell(i, py);
+                    fGap = GET_CATTR(g) == 0 && GET_CTEXT(g) != 0 && GET_CCOLOR(g) == m_color;
+                }
+
+                if(fGap)
+                    while(m_posx < px)
+                        rc = _WriteWChar(GET_CTEXT(m_shadow.GetCell(m_posx, py)));
+                else
+                    rc = GotoXY(px, py);
             }
-            
-            //LOG(DEBUG) << "x=" << x << " y=" << y << " ch=" << std::hex << ch << std::dec;
-            rc = _WriteWChar(ch);
-            
-            if(fLast && y == sizey - 1 && x == sizex - 2)
-                break;
+
+            rc = SetTextAttr(GET_CCOLOR(c))
+            && _WriteWChar(ch);
+            m_shadow.SetCell(px, py, c);
         }
     }
 
-    if(fLast)
+    if(fLast && m_sizex > 1)
     {
-        rc = WriteLastChar(
-            GET_CTEXT(block.GetCell(m_sizex - 2, m_sizey - 1)), 
-            GET_CTEXT(block.GetCell(m_sizex - 1, m_sizey - 1)));
+        cell_t prev = left <= m_sizex - 2 ? block.GetCell(xoffset + m_sizex - 2 - left, yoffset + sizey - 1) : m_shadow.GetCell(m_sizex - 2, m_sizey - 1);
+        cell_t last = block.GetCell(xoffset + sizex - 1, yoffset + sizey - 1);
+
+        if(prev != m_shadow.GetCell(m_sizex - 2, m_sizey - 1) || last != m_shadow.GetCell(m_sizex - 1, m_sizey - 1))
+        {
+            //both chars are printed with color of previous char
+            rc = SetTextAttr(GET_CCOLOR(prev))
+            && WriteLastChar(GET_CTEXT(prev), GET_CTEXT(last));
+            m_shadow.SetCell(m_sizex - 2, m_sizey - 1, prev);
+            m_shadow.SetCell(m_sizex - 1, m_sizey - 1, last);
+        }
     }
 
-    rc = Flush();
     return rc;
 }
 
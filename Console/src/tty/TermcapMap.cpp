@@ -89,6 +89,7 @@ std::list<ScreenCap> g_screenCap
   {"bc", S_CursorLeft,    ""},
   {"le", S_CursorLeft,    "\x8"},
   {"nd", S_CursorRight,   ""},
+  {"RI", S_CursorRightN,  ""},
   {"up", S_CursorUp,      ""},
   {"do", S_CursorDown,    ""},
   {"nl", S_CursorDown,    "\xa"},
@@ -33,10 +33,82 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "Console/ScreenBuffer.h"
 
 #include <iostream>
+#include <iomanip>
+#include <functional>
+#include <chrono>
+#include <cstdio>
+
+#ifndef WIN32
+#include <unistd.h>
+#endif
 
 using namespace _Utils;
 using namespace _Console;
 
+void ScreenBufferTest()
+{
+    std::cout << "ScreenBuffer test" << std::endl;
+    LOG(INFO) << "ScreenBuffer test";
+
+    const color_t color {TEXT_GREEN | FON_BLUE};
+    ScreenBuffer buff(10, 3);
+    size_t left;
+    size_t right;
+
+    //new buffer is dirty as a whole
+    _assert(buff.IsDirty());
+    _assert(buff.GetDirty(2, left, right) && left == 0 && right == 9);
+    buff.ClearDirty();
+    _assert(!buff.IsDirty());
+    _assert(!buff.GetDirty(0, left, right));
+
+    //only changed cells are marked
+    _assert(buff.FillSpan(0, 0, 10, 0));
+    _assert(!buff.IsDirty());
+    _assert(buff.WriteSpan(2, 0, u"abcd", color));
+    _assert(buff.GetDirty(0, left, right) && left == 2 && right == 5);
+    _assert(!buff.GetDirty(1, left, right));
+    _assert(buff.WriteSpan(3, 0, u"bX", color));
+    _assert(buff.GetDirty(0, left, right) && left == 2 && right == 5);
+    buff.ClearDirty();
+    _assert(buff.WriteSpan(3, 0, u"bY", color));
+    _assert(buff.GetDirty(0, left, right) && left == 4 && right == 4);
+    _assert(GET_CTEXT(buff.GetCell(4, 0)) == 'Y');
+    buff.ClearDirty();
+
+    //span till the line end
+    _assert(buff.WriteSpan(6, 1, u"wxyz", std::vector<color_t>{color, color, color, color, color}));
+    _assert(buff.GetDirty(1, left, right) && left == 6 && right == 9);
+    _assert(GET_CTEXT(buff.GetCell(9, 1)) == 'z');
+    _assert(GET_CTEXT(buff.GetCell(0, 2)) == 0);
+    _assert(buff.ColorSpan(8, 1, {TEXT_RED, TEXT_RED}));
+    _assert(GET_CCOLOR(buff.GetCell(9, 1)) == TEXT_RED && GET_CTEXT(buff.GetCell(9, 1)) == 'z');
+    _assert(GET_CCOLOR(buff.GetCell(7, 1)) == color);
+
+    //too long span is reported and cut by the line end
+    buff.ClearDirty();
+    _assert(buff.FillSpan(7, 1, 5, MAKE_CELL(0, color, '-')));
+    _assert(buff.GetDirty(1, left, right) && left == 7 && right == 9);
+    _assert(!buff.GetDirty(2, left, right));
+    _assert(GET_CTEXT(buff.GetCell(0, 2)) == 0);
+    _assert(buff.FillSpan(10, 1, 0, 0));
+
+    //marked block is cut by the buffer size
+    buff.ClearDirty();
+    buff.MarkDirty(3, 1, 20, 20);
+    _assert(!buff.GetDirty(0, left, right));
+    _assert(buff.GetDirty(1, left, right) && left == 3 && right == 9);
+    _assert(buff.GetDirty(2, left, right) && left == 3 && right == 9);
+    buff.MarkDirty(1, 2, 1, 2);
+    _assert(buff.GetDirty(2, left, right) && left == 1 && right == 9);
+
+    //scrolled cells are not marked
+    buff.ClearDirty();
+    _assert(buff.ScrollBlock(0, 0, 9, 2, 1, scroll_t::SCROLL_UP));
+    _assert(!buff.IsDirty());
+    _assert(GET_CTEXT(buff.GetCell(9, 0)) == '-');
+}
+
 void ConsoleTest()
 {
     std::cout << "Console test" << std::endl;
@@ -134,9 +206,173 @@ void ConsoleTest()
     LOG(INFO) << "ConsoleOutput test end";
 }
 
-int main()
+#ifndef WIN32
+//count bytes sent to terminal for typical editing steps
+void OutputBenchmark()
+{
+    const pos_t sizex {100};
+    const pos_t sizey {40};
+    const color_t colorText {TEXT_RED | TEXT_GREEN | TEXT_BLUE | FON_BLUE};
+    const color_t colorNum {TEXT_GREEN | TEXT_BRIGHT | FON_BLUE};
+    const color_t colorComment {TEXT_BLUE | TEXT_GREEN | FON_BLUE};
+    const color_t colorStatus {TEXT_BLUE | FON_RED | FON_GREEN | FON_BLUE};
+    const color_t colorDialog {TEXT_BLUE | TEXT_GREEN | TEXT_RED | TEXT_BRIGHT | FON_GREEN};
+
+    //terminal output goes to temporary file
+    fflush(stdout);
+    FILE* out = tmpfile();
+    int stdOut = dup(STDOUT_FILENO);
+    if (!out || stdOut < 0 || dup2(fileno(out), STDOUT_FILENO) < 0)
+    {
+        std::cerr << "Output benchmark: can't redirect output" << std::endl;
+        return;
+    }
+    setenv("TERM", "xterm", 0);
+
+    std::vector<std::string> text;
+    for (int i = 0; i < 2000; ++i)
+    {
+        std::string str(static_cast<size_t>(i % 7) * 4, ' ');
+        str += "value" + std::to_string(i) + " = compute(" + std::to_string(i * 37 % 1000) + ", data[i]);";
+        if (i % 5 == 0)
+            str += " //step " + std::to_string(i);
+        text.push_back(str);
+    }
+
+    ScreenBuffer buff(sizex, sizey);
+    size_t top {};
+    pos_t cx {};
+    pos_t cy {};
+
+    auto paintLine = [&](pos_t y) {
+        const std::string& str = text[top + y];
+        color_t color = colorText;
+        for (pos_t x = 0; x < sizex; ++x)
+        {
+            char c = static_cast<size_t>(x) < str.size() ? str[x] : ' ';
+            if (c == '/')
+                color = colorComment;
+            buff.SetCell(x, 1 + y, MAKE_CELL(0, color == colorText && isdigit(c) ? colorNum : color, c));
+        }
+    };
+    auto paintStatus = [&]() {
+        std::string str = " L:" + std::to_string(top + cy + 1) + " C:" + std::to_string(cx + 1);
+        str.resize(sizex, ' ');
+        for (pos_t x = 0; x < sizex; ++x)
+            buff.SetCell(x, sizey - 1, MAKE_CELL(0, colorStatus, str[x]));
+    };
+    auto paint = [&]() {
+        for (pos_t x = 0; x < sizex; ++x)
+            buff.SetCell(x, 0, MAKE_CELL(0, colorStatus, x < 4 ? "File"[x] : ' '));
+        for (pos_t y = 0; y < sizey - 2; ++y)
+            paintLine(y);
+        paintStatus();
+    };
+
+    ScreenTTY screen;
+    screen.Init();
+    screen.SetSize(sizex, sizey);
+
+    struct Step
+    {
+        std::string name;
+        size_t count;
+        std::function<void()> func;
+    };
+    std::vector<Step> steps
+    {
+        {"open file", 1, [&]() {
+            paint();
+            screen.WriteBlock(0, 0, sizex - 1, sizey - 1, buff);
+        }},
+        {"type char", 200, [&]() {
+            std::string& str = text[top + cy];
+            if (str.size() > static_cast<size_t>(sizex - 20))
+            {
+                str.clear();
+                cx = 0;
+            }
+            str.insert(static_cast<size_t>(cx), 1, static_cast<char>('a' + cx % 26));
+            ++cx;
+            paintLine(cy);
+            paintStatus();
+            screen.WriteBlock(0, 1 + cy, sizex - 1, 1 + cy, buff, 0, 1 + cy);
+            screen.WriteBlock(0, sizey - 1, sizex - 1, sizey - 1, buff, 0, sizey - 1);
+        }},
+        {"cursor down", 30, [&]() {
+            cy = (cy + 1) % (sizey - 2);
+            paintStatus();
+            screen.WriteBlock(0, sizey - 1, sizex - 1, sizey - 1, buff, 0, sizey - 1);
+        }},
+        {"page down", 20, [&]() {
+            top += sizey - 2;
+            paint();
+            screen.WriteBlock(0, 1, sizex - 1, sizey - 1, buff, 0, 1);
+        }},
+        {"move 5 lines", 20, [&]() {
+            top += 5;
+            paint();
+            screen.WriteBlock(0, 1, sizex - 1, sizey - 1, buff, 0, 1);
+        }},
+        {"dialog", 10, [&]() {
+            for (pos_t y = 10; y < 22; ++y)
+                for (pos_t x = 20; x < 80; ++x)
+                    buff.SetCell(x, y, MAKE_CELL(0, colorDialog, y == 10 ? '-' : ' '));
+            screen.WriteBlock(20, 10, 79, 21, buff, 20, 10);
+            //close dialog and refresh all screen
+            paint();
+            screen.WriteBlock(0, 0, sizex - 1, sizey - 1, buff);
+        }},
+        {"refresh", 10, [&]() {
+            screen.WriteBlock(0, 0, sizex - 1, sizey - 1, buff);
+        }}
+    };
+
+    auto written = [&]() {
+        screen.Flush();
+        return static_cast<size_t>(lseek(STDOUT_FILENO, 0, SEEK_CUR));
+    };
+
+    std::vector<size_t> bytes;
+    std::vector<long long> time;
+    size_t total = written();
+    for (auto& step : steps)
+    {
+        size_t begin = written();
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < step.count; ++i)
+            step.func();
+        time.push_back(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+        bytes.push_back(written() - begin);
+    }
+    total = written() - total;
+    screen.Deinit();
+
+    fflush(stdout);
+    dup2(stdOut, STDOUT_FILENO);
+    close(stdOut);
+    fclose(out);
+
+    std::cout << "Output benchmark " << sizex << "x" << sizey << std::endl;
+    for (size_t i = 0; i < steps.size(); ++i)
+        std::cout << "  " << std::left << std::setw(12) << steps[i].name << std::right
+            << std::setw(6) << steps[i].count << " steps " << std::setw(9) << bytes[i] << " bytes "
+            << std::setw(7) << bytes[i] / steps[i].count << " per step " << std::setw(7) << time[i] << " us" << std::endl;
+    std::cout << "  total " << total << " bytes" << std::endl;
+}
+#endif
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[])
 {
     ConfigureLogger("m-%datetime{%Y%M%d}.log", 0x200000, false);
+    ScreenBufferTest();
+#ifndef WIN32
+    if (argc > 1 && std::string(argv[1]) == "bench")
+    {
+        OutputBenchmark();
+        return 0;
+    }
+#endif
     ConsoleTest();
 
     LOG(INFO) << "End";
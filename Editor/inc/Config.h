@@ -178,12 +178,18 @@ class DialogsConfig
     inline static const std::string MaskKey     { "MaskList" };
     inline static const std::string FindKey     { "FindList" };
     inline static const std::string ReplaceKey  { "ReplaceList" };
+    inline static const std::string UseIndexKey { "UseIndex" };
+    inline static const std::string BinaryKey   { "ScanBinary" };
+    inline static const std::string IndexKey    { "IndexList" };
 
 public:
     std::string             filePath;
     std::list<std::string>  fileMaskList;
     std::list<std::string>  findList;
     std::list<std::string>  replaceList;
+    bool                    useIndex{};
+    bool                    scanBinary{};
+    std::list<std::string>  indexList;
 
     bool Load(const nlohmann::json& json);
     bool Save(nlohmann::json& json) const;
@@ -37,6 +37,8 @@ using namespace _WndManager;
 namespace _Editor
 {
 
+class EditorWnd;
+
 /////////////////////////////////////////////////////////////////////////////
 enum class FileDlgMode
 {
@@ -123,6 +125,28 @@ public:
     size_t GetLine() { return static_cast<size_t>(std::stoull(m_line)); }
 };
 
+/////////////////////////////////////////////////////////////////////////////
+class FuncListDialog : public Dialog
+{
+    const std::map<size_t, std::string>& m_funcList;
+    size_t              m_line{};
+    std::u16string      m_filter;
+    std::vector<size_t> m_lines;
+
+    size_t FillList();
+
+public:
+    static std::string s_filter;
+
+    FuncListDialog(const std::map<size_t, std::string>& funcList, size_t line, pos_t x = MAX_COORD, pos_t y = MAX_COORD);
+
+    virtual input_t EventProc(input_t code) override final;
+    virtual bool OnActivate() override final;
+    virtual bool OnClose(int id) override final;
+
+    size_t GetLine() const { return m_line; }
+};
+
 /////////////////////////////////////////////////////////////////////////////
 struct FindReplaceVars
 {
@@ -135,6 +159,7 @@ struct FindReplaceVars
     bool            directionUp{};
     bool            inSelected{};
     bool            findWord{};
+    bool            regex{};
 
     bool            replaceMode{};
     bool            noPrompt{};
@@ -147,6 +172,15 @@ class FindDialog : public Dialog
 {
     bool m_replace;//false-find true-replace
 
+    //incremental search
+    EditorWnd*      m_editor{};
+    std::u16string  m_incStr;
+    bool            m_incCase{};
+    bool            m_incWord{};
+    bool            m_incOff{};
+
+    bool IsChecked(int id);
+
 public:
     static FindReplaceVars s_vars;
     
@@ -155,6 +189,7 @@ public:
 
     FindDialog(bool replace, pos_t x = MAX_COORD, pos_t y = MAX_COORD);
 
+    virtual input_t EventProc(input_t code) override final;
     virtual bool OnActivate() override final;
     virtual bool OnClose(int id) override final;
 };
@@ -195,6 +230,8 @@ struct FindFileDialogVars
 {
     bool            inOpen{};
     bool            recursive{true};
+    bool            useIndex{};
+    bool            binary{};
 };
 
 class FindFileDialog : public Dialog
@@ -222,7 +259,7 @@ class SearchFileDialog : public Dialog
     size_t              m_pos{};
     bool                m_cancel{};
 
-    bool ScanDir(const path_t& path);
+    bool Search(const path_t& path);
     bool ShowProgress();
 
     std::string&    m_mask{ FileDialog::s_vars.file };
@@ -231,12 +268,17 @@ class SearchFileDialog : public Dialog
     bool            m_recursive{ FindFileDialog::s_vars.recursive };
     bool            m_checkCase{ FindDialog::s_vars.checkCase };
     bool            m_findWord{ FindDialog::s_vars.findWord };
+    bool            m_regex{ FindDialog::s_vars.regex };
+    std::u16string& m_replaceStr{ FindDialog::s_vars.replaceStrW };
+    EditorWnd*      m_foundWnd{};
+    bool            m_replace{};//replace in files without editor
+    std::string     m_summary;
 
 public:
     static std::vector<path_t>  s_foundList;
     static size_t               s_listPos;
 
-    SearchFileDialog(pos_t x = MAX_COORD, pos_t y = MAX_COORD);
+    SearchFileDialog(EditorWnd* foundWnd = nullptr, bool replace = false, pos_t x = MAX_COORD, pos_t y = MAX_COORD);
 
     virtual input_t Activate() override final;
 };
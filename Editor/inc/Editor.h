@@ -27,16 +27,21 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #pragma once
 
 #include "utils/MemBuff.h"
+#include "utils/Regex.h"
+#include "utils/StrFinder.h"
+#include "utils/MultiStrFinder.h"
 #include "Console/Types.h"
 #include "UndoList.h"
 #include "WndManager/Wnd.h"
 #include "LexParser.h"
+#include "MatchIndex.h"
 
 #include <unordered_set>
 #include <filesystem>
 #include <limits>
 #include <algorithm>
 #include <functional>
+#include <tuple>
 
 
 #if !defined(__APPLE__) && !defined(__FreeBSD__)
@@ -89,10 +94,50 @@ constexpr uintmax_t MAX_PARSED_SIZE{ 0x2000000 }; // 32 MB
 constexpr size_t    c_buffsize{ 0x200000 };//2MB
 using read_buff_t = std::array<char, c_buffsize>;
 
+constexpr size_t    c_scanBuffSize{ 0x40000 };//256KB
+//buffers reused for scanning of many files in one thread
+struct ScanBuff
+{
+    std::string                             cp;
+    std::shared_ptr<iconvpp::CpConverter>   converter;
+    bool                                    rawData{};  //code page allows search in raw data
+    std::vector<char>                       buff;
+    std::u16string                          u16buff;
+    std::u16string                          upperBuff;
+    std::u16string                          prevBuff;
+
+    void    SetCp(const std::string& newCp);
+};
+
+constexpr size_t    c_binaryCheckSize{ 0x2000 };//8KB
+//file with zero byte in the beginning is binary
+inline bool IsBinaryData(std::string_view data)
+{
+    return data.substr(0, c_binaryCheckSize).find('\0') != std::string_view::npos;
+}
+
+constexpr size_t    c_maxFileMatches{ 0x1000 };
+constexpr size_t    c_maxMatchStr{ 0x100 };
+//string found in file
+struct FileMatch
+{
+    size_t          line;
+    size_t          pos;    //position in line
+    size_t          size;
+    size_t          offset; //position of str in line
+    std::u16string  str;    //part of line around found
+};
+
+//substrings for replacing in line: position, length and new substring
+using line_replace_t = std::vector<std::tuple<size_t, size_t, std::u16string>>;
+
 class Editor
 {
     inline const static std::string     c_utf8Bom{ "\xef\xbb\xbf" };
     inline const static std::u16string  c_utf16Bom{ u"\xfeff" };
+    inline const static size_t          c_findNearBlocks{ 4 };      //checked without workers
+    inline const static size_t          c_findBlocksPerThread{ 4 }; //acquired blocks for search
+    inline const static size_t          c_matchIndexStep{ 0x1000 }; //lines between stop checking
 
 private:
     std::shared_ptr<iconvpp::CpConverter>       m_converter;
@@ -106,6 +151,7 @@ private:
 
     UndoList        m_undoList;
     LexParser       m_lexParser;
+    MatchIndex      m_matchIndex;
 
     //config variables
     std::string     m_cp{};
@@ -127,6 +173,7 @@ private:
         uintmax_t& fileOffset, bool eof);
     bool    FillStrOffset(std::shared_ptr<StrBuff<std::string, std::string_view>> strBuff, size_t size, bool last, size_t& rest);
     bool    ImproveBuff(std::list<std::shared_ptr<StrBuff<std::string, std::string_view>>>::iterator strBuff);
+    bool    ParseBuffer();
 
     std::u16string  _GetStr(size_t line, size_t offset, size_t size);
     bool    _AddStr(size_t n, const std::u16string& str);
@@ -136,6 +183,8 @@ private:
     bool    ConvertStr(const std::u16string& str, std::string& buff) const;
 
     bool    LoadBuff(uint64_t offset, size_t size, std::shared_ptr<std::string> buff);
+    std::optional<size_t> _FindStrLine(const std::function<size_t(std::string_view, size_t)>& find,
+        size_t line, size_t end, bool up, const std::function<bool(size_t)>& progress);
     bool    BackupFile();
     bool    Clear();
 
@@ -170,6 +219,7 @@ public:
 
     using progress_func = std::function<bool()>;
     static bool ScanFile(const std::filesystem::path& file, const std::u16string& toFind, const std::string& cp, bool checkCase, bool findWord, progress_func func);
+    static bool ScanFile(const std::filesystem::path& file, const std::u16string& toFind, const std::string& cp, bool checkCase, bool findWord, ScanBuff& buff, progress_func func, std::vector<FileMatch>* found = nullptr, bool binary = false);
 
     bool                    SetFilePath(const std::filesystem::path& file);
     std::filesystem::path   GetFilePath() const {return m_file;}
@@ -207,9 +257,26 @@ public:
     uint64_t                GetSize() const         {return m_buffer.GetSize(); }
     bool                    SetCurStr(size_t line);
     bool                    FlushCurStr();
+    bool                    IsCurStrChanged(size_t line) const {return m_curChanged && line == m_curStr;}
 
     std::u16string          GetStr(size_t line, size_t offset = 0, size_t size = MAX_STRLEN + 1);
+    size_t                  GetColumn(size_t line, size_t pos);
     std::u16string          GetStrForFind(size_t line, bool checkCase, bool fast);
+    bool                    CheckRegex(size_t line, Regex& regex);
+    std::optional<StrFinder> GetStrFinder(const std::u16string& str, bool checkCase);
+    static std::optional<StrFinder> MakeStrFinder(std::u16string_view str, bool checkCase, iconvpp::CpConverter& converter);
+    std::optional<size_t>   FindStrLine(const StrFinder& finder, size_t line, size_t end, bool up, const std::function<bool(size_t)>& progress);
+    std::optional<MultiStrFinder> GetMultiStrFinder(const std::vector<std::u16string>& strs, bool checkCase);
+    std::optional<size_t>   FindStrLine(const MultiStrFinder& finder, size_t line, size_t end, bool up, const std::function<bool(size_t)>& progress);
+    static std::u16string   GetCaseVariants(char16_t c);
+    //sameCase allows only the same case in whole string if there are too many variants
+    static bool             AddMultiStr(MultiStrFinder& finder, const std::u16string& str, size_t id, bool checkCase,
+                                const std::function<bool(char16_t, std::string&)>& encode, bool sameCase = true);
+
+    //index of found strings
+    bool                    SetMatchIndex(const std::string& key, MatchIndex::match_func func, std::optional<StrFinder> finder = std::nullopt);
+    bool                    UpdateMatchIndex(const std::function<bool()>& stop);
+    const MatchIndex*       GetMatchIndex(const std::string& key, bool flush = true);
 
     //editor API with undo
     bool                    CorrectTab(bool save, size_t line, std::u16string& str);
@@ -226,6 +293,7 @@ public:
     bool                    ClearSubstr(bool save, size_t line, size_t pos, size_t len);
     bool                    DelSubstr(bool save, size_t line, size_t pos, size_t len);
     bool                    ReplaceSubstr(bool save, size_t line, size_t pos, size_t len, const std::u16string& substr);
+    bool                    ReplaceLine(bool save, size_t line, const line_replace_t& replace);
     bool                    Indent(bool save, size_t line, size_t pos, size_t len, size_t n);
     bool                    Unindent(bool save, size_t line, size_t pos, size_t len, size_t n);
 
@@ -249,6 +317,8 @@ public:
     std::string             GetParseStyle() const { return m_lexParser.GetParseStyle(); }
     bool                    GetColor(size_t line, const std::u16string& str, std::vector<color_t>& buff, size_t len);
     bool                    CheckLexPair(size_t& line, size_t& pos);
+    bool                    IsParsingEnabled() const { return m_lexParser.IsParsingEnabled(); }
+    const lex_map&          GetFuncList() const { return m_lexParser.GetFuncList(); }
 };
 
 using EditorPtr = std::shared_ptr<Editor>;
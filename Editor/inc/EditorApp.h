@@ -26,6 +26,10 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 #include "WndManager/App.h"
 #include "EditorWnd.h"
+#include "TrigramIndex.h"
+
+#include <list>
+#include <set>
 
 
 namespace _Editor
@@ -51,8 +55,10 @@ class EditorApp : public Application
     static std::unordered_map<AppCmd, AppFunc> s_funcMap;
     
     inline static const size_t c_maxRecentFiles{16};
+    inline static const std::string c_foundWndName{"Found in files"};
     std::deque<file_t> m_recentFiles;
     std::unordered_map<Wnd*, std::shared_ptr<EditorWnd>> m_editors;
+    std::list<std::unique_ptr<TrigramIndex>> m_fileIndexes;
 
     bool m_wait{};
     bool m_run{};
@@ -102,6 +108,9 @@ public:
     static bool StatusMark(mark_status mark = mark_status::no);
 
     Wnd* GetEditorWnd(std::filesystem::path path);
+    std::set<std::filesystem::path> GetEditorFiles();
+    EditorWnd* GetFoundWnd(bool replace = false);
+    TrigramIndex* GetFileIndex(const std::filesystem::path& path, bool create);
     bool OpenFile(const std::filesystem::path& path, const std::string& parseMode, const std::string& cp, bool ro = false, bool log = false);
 
     //editor app commands
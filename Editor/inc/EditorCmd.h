@@ -144,6 +144,9 @@ enum EditorCmd : input_t
     E_CTRL_FINDDN,
     E_CTRL_FINDUPW,
     E_CTRL_FINDDNW,
+    E_CTRL_HIGHLIGHT,
+    E_CTRL_HIGHLIGHTUP,
+    E_CTRL_HIGHLIGHTDN,
     E_CTRL_REPLACE,
     E_CTRL_REPEAT,
     E_DLG_GOTO,
@@ -31,6 +31,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "EditorCmd.h"
 
 #include <functional>
+#include <map>
 #include <unordered_map>
 
 using namespace _WndManager;
@@ -126,6 +127,17 @@ class EditorWnd : public FrameWnd
     size_t          m_foundSize{};
     size_t          m_progress{};
     bool            m_markAllFound{};
+    //regular expression search
+    std::unique_ptr<Regex>  m_regex;    //for string in UTF-8
+    std::unique_ptr<Regex>  m_rawRegex; //for file string in its code page
+    std::string             m_regexKey;
+    //key of found strings index
+    std::string             m_matchKey;
+
+    //highlighted strings, every string has own color
+    std::vector<std::u16string>     m_highlight;
+    bool                            m_highlightCase{};
+    std::optional<MultiStrFinder>   m_highlightFinder;  //for screen string in UTF-8
 
     //file position info
     size_t          m_infoStrSize{};
@@ -147,10 +159,45 @@ class EditorWnd : public FrameWnd
     std::shared_ptr<Diff>   m_diff;
     int                     m_diffBuff{-1};
 
+    //found in files results, key is line in window
+    struct FoundInFile
+    {
+        std::filesystem::path   file;
+        FileMatch               match;
+    };
+    bool                            m_foundWnd{};
+    std::map<size_t, FoundInFile>   m_foundInFiles;
+
+    //incremental search from find dialog
+    struct IncFindState
+    {
+        bool            active{};
+        bool            found{};
+        bool            notFound{};
+        std::u16string  str;
+        bool            checkCase{};
+        bool            findWord{};
+        //string is not found before this position
+        size_t          x{};
+        size_t          y{};
+        //state before search
+        size_t          beginX{};
+        size_t          beginY{};
+        size_t          firstLine{};
+        size_t          xOffset{};
+        std::u16string  findStr;
+        std::string     matchKey;
+        bool            markAllFound{};
+    };
+    IncFindState                    m_incFind;
+
     bool    _GotoXY(size_t x, size_t y, bool top = false);
     bool    InvalidateRect(pos_t x = 0, pos_t y = 0, pos_t sizex = 0, pos_t sizey = 0);
     bool    PrintStr(pos_t x, pos_t y, const std::u16string& str, size_t offset, size_t len);
-    bool    MarkAllFound(const std::u16string& str, std::vector<color_t>& colorBuff);
+    bool    MarkAllFound(size_t line, const std::u16string& str, std::vector<color_t>& colorBuff);
+    bool    MarkHighlight(const std::u16string& str, std::vector<color_t>& colorBuff);
+    bool    GetHighlight(const std::u16string& str, std::vector<MultiStrFinder::Match>& found) const;
+    bool    FindHighlight(bool up);
 
     bool    UpdateAccessInfo();
     bool    UpdateNameInfo();
@@ -171,10 +218,23 @@ class EditorWnd : public FrameWnd
     bool    Find(bool silence = false);
     bool    FindUp(bool silence = false);
     bool    FindDown(bool silence = false);
-    bool    IsWord(const std::u16string& str, size_t offset, size_t len);
+    bool    PrepareRegex();
+    bool    MatchRegex(const std::u16string& wstr, size_t from, size_t to, bool last, size_t& x, size_t& size);
+    bool    FindRegexUp(bool silence);
+    bool    FindRegexDown(bool silence);
+    bool    GetRegexReplace(size_t& len, std::u16string& replace);
+    bool    ReplaceAll(size_t& count, bool& userBreak);
+    bool    ShowFound(size_t x, size_t y, size_t size, bool silence);
+    bool    StartMatchIndex();
+    bool    UpdateMatchIndex();
+    const MatchIndex* GetMatchIndex();
+    bool    FindInIndex(const MatchIndex& index, bool up, size_t line, size_t offset, size_t end, bool silence);
+    bool    ShowMatchNumber();
     bool    CheckFileChanging();
     bool    ReplaceSubstr(size_t line, size_t pos, size_t len, const std::u16string& substr);
     bool    TryDeleteSelectedBlock();
+    bool    GotoFoundInFile();
+    bool    IncFindRestore();
 
 public:
     EditorWnd(pos_t left = 0, pos_t top = 0, pos_t sizex = 0, pos_t sizey = 0, int border = BORDER_TITLE)
@@ -220,6 +280,19 @@ public:
     bool    IsLog()         { return m_log; }
     bool    SetLog(bool log){ return m_log = log; }
 
+    bool    IncFindStart();
+    bool    IncFind(const std::u16string& str);
+    bool    IncFindNext();
+    bool    IncFindEnd(bool ok);
+
+    bool    IsFoundWnd()    { return m_foundWnd; }
+    bool    StartFoundInFiles(const std::u16string& title);
+    bool    AddFoundInFile(const std::filesystem::path& file, const std::vector<FileMatch>& matches);
+    bool    AddReplacedFile(const std::filesystem::path& file, size_t count);
+    bool    AddReplaceSummary(const std::string& summary, const std::vector<std::filesystem::path>& failed);
+
+    static bool IsWord(const std::u16string& str, size_t offset, size_t len);
+
     bool    EditWndCopy(EditorWnd* from);
     bool    EditWndMove(EditorWnd* from);
     bool    GetWord(std::u16string& buff);
@@ -285,6 +358,7 @@ public:
     bool EditCopyToClipboard(input_t cmd);
     bool EditCutToClipboard(input_t cmd);
     bool EditPasteFromClipboard(input_t cmd);
+    bool EditPasteTerminal(input_t cmd);
     bool EditUndo(input_t cmd);
     bool EditRedo(input_t cmd);
 
@@ -293,6 +367,9 @@ public:
     bool CtrlFindDown(input_t cmd);
     bool FindUpWord(input_t cmd);
     bool FindDownWord(input_t cmd);
+    bool Highlight(input_t cmd);
+    bool HighlightUp(input_t cmd);
+    bool HighlightDown(input_t cmd);
     bool Replace(input_t cmd);
     bool Repeat(input_t cmd);
 
@@ -0,0 +1,77 @@
+/*
+FreeBSD License
+
+Copyright (c) 2020-2021 vikonix: valeriy.kovalev.software@gmail.com
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include "FileSearcher.h"
+
+#include <set>
+
+
+namespace _Editor
+{
+
+//////////////////////////////////////////////////////////////////////////////
+//replace of string in files without editor windows
+//file is read by blocks and only changed lines are converted back to its code page,
+//result is written to temporary file that renames to original one
+class FileReplacer : public FileSearcher
+{
+    inline static const std::string c_tmpExt{ ".replace~" };
+
+    std::u16string      m_findStr;      //in upper case for case insensitive search
+    std::unique_ptr<searcher_t> m_searcher;
+    std::u16string      m_replace;
+    std::string         m_replaceU8;    //format for regex
+    bool                m_regex{};
+    bool                m_dryRun{};     //only count matches
+    std::string         m_error;
+
+    std::atomic<size_t>     m_replaced{};
+    std::mutex              m_failedMutex;
+    std::vector<path_t>     m_failed;
+    //real files taken by workers, file can be reached by links too
+    std::mutex              m_targetMutex;
+    std::set<path_t>        m_targets;
+
+    size_t  ReplaceStr(const std::u16string& str, const std::u16string& findStr, size_t begin, size_t end, Regex* regex, std::u16string& out);
+    bool    ReplaceFile(File& file, ScanBuff& buff, const path_t& target, const path_t& tmpPath);
+
+protected:
+    virtual bool ScanFile(File& file, ScanBuff& buff) override;
+
+public:
+    FileReplacer(const std::u16string& toFind, const std::u16string& replace, const std::string& cp, bool checkCase, bool findWord, bool regex);
+    virtual ~FileReplacer() {Stop();}
+
+    void                SetDryRun(bool dryRun) {m_dryRun = dryRun;}
+    bool                IsValid() const     {return m_error.empty();}
+    const std::string&  GetError() const    {return m_error;}
+    size_t              GetReplaced() const {return m_replaced;}
+    std::vector<path_t> GetFailed();
+};
+
+} //namespace _Editor
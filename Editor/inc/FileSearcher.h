@@ -0,0 +1,136 @@
+/*
+FreeBSD License
+
+Copyright (c) 2020-2021 vikonix: valeriy.kovalev.software@gmail.com
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include "utils/Directory.h"
+#include "Editor.h"
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <optional>
+#include <set>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+
+namespace _Editor
+{
+
+using _Utils::path_t;
+
+//////////////////////////////////////////////////////////////////////////////
+//search of string in files with threads pool
+//walker thread scans directories and puts files to workers queues,
+//worker takes file from own queue or steals it from other worker
+class FileSearcher
+{
+public:
+    using filter_func = std::function<bool(const path_t& file)>;
+    //file, matches count and found matches
+    using found_t = std::tuple<path_t, size_t, std::vector<FileMatch>>;
+
+protected:
+    struct File
+    {
+        size_t                  n;      //number in walk order
+        path_t                  path;
+        size_t                  count{};
+        std::vector<FileMatch>  matches;
+    };
+
+    std::u16string      m_toFind;
+    std::string         m_cp;
+    bool                m_checkCase{};
+    bool                m_findWord{};
+    bool                m_binary{};     //scan files with zero bytes
+    std::atomic_bool    m_cancel{ false };
+
+    //checks one file in worker thread
+    virtual bool ScanFile(File& file, ScanBuff& buff);
+
+private:
+    inline static const size_t  c_maxQueued{ 0x1000 };  //files waiting for scan
+
+    struct Worker
+    {
+        std::mutex          mutex;
+        std::deque<File>    files;
+    };
+
+    bool                m_allMatches{};
+    std::string         m_mask;
+    bool                m_recursive{};
+    filter_func         m_filter;
+
+    std::thread                             m_walker;
+    std::vector<std::thread>                m_threads;
+    std::vector<std::unique_ptr<Worker>>    m_workers;
+    size_t                                  m_walkCount{};
+    std::set<path_t>                        m_walkedDirs;
+
+    std::atomic_bool                        m_walked{ false };
+    std::atomic<size_t>                     m_queued{};
+    std::atomic<size_t>                     m_running{};
+    std::atomic<size_t>                     m_scanned{};
+    std::mutex                              m_waitMutex;
+    std::condition_variable                 m_waitCondition;
+
+    std::mutex                              m_foundMutex;
+    std::vector<File>                       m_found;
+    size_t                                  m_taken{};
+    path_t                                  m_curPath;
+
+    void    Walk(const path_t& path);
+    bool    WalkDir(const path_t& path);
+    void    Scan(size_t worker);
+    std::optional<File> PopFile(size_t worker);
+
+public:
+    FileSearcher(const std::u16string& toFind, const std::string& cp, bool checkCase, bool findWord, bool allMatches = false)
+        : m_toFind{toFind}, m_cp{cp}, m_checkCase{checkCase}, m_findWord{findWord}, m_allMatches{allMatches} {}
+    virtual ~FileSearcher() {Stop();}
+
+    void    SetBinary(bool binary)  {m_binary = binary;}
+    bool    Start(const path_t& path, const std::string& mask, bool recursive, filter_func filter = nullptr);
+    void    Stop();
+    bool    IsDone() const      {return m_running == 0;}
+    size_t  GetScanned() const  {return m_scanned;}
+    path_t  GetCurPath();
+
+    //files found after previous call in found order
+    std::vector<found_t> GetFound();
+    //all found files in walk order
+    std::vector<path_t> GetResult();
+};
+
+} //namespace _Editor
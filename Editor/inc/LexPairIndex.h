@@ -0,0 +1,99 @@
+/*
+FreeBSD License
+
+Copyright (c) 2020-2021 vikonix: valeriy.kovalev.software@gmail.com
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <array>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+
+namespace _Editor
+{
+
+using lex_map = std::map<size_t, std::string>;
+
+//////////////////////////////////////////////////////////////////////////////
+//index of brackets from lexem strings
+//lines are grouped to leaves, every tree node keeps sum and minimal prefix sum
+//of brackets for each bracket type and for both comment states at the node begin
+class LexPairIndex
+{
+    inline static const size_t c_leafLines{ 256 };
+    inline static const size_t c_pairTypes{ 4 };
+
+    struct LexSum
+    {
+        int     sum{};
+        int     minPre{};
+    };
+
+    struct IndexNode
+    {
+        size_t  strCount{};
+        std::array<bool, 2> exit{ false, true };                    //comment state at the end
+        std::array<std::array<LexSum, c_pairTypes>, 2> pair{};      //[comment state at the begin][pair type]
+    };
+
+    bool                    m_valid{};
+    std::vector<IndexNode>  m_leaf;
+    std::vector<IndexNode>  m_tree;
+
+    static int  GetPairType(char c, int& d);
+    template<typename F>
+    static void ScanLex(const std::string& lex, bool& comment, F func);
+
+    static IndexNode CalcLeaf(const lex_map& lexMap, size_t begin, size_t strCount);
+    static IndexNode Merge(const IndexNode& left, const IndexNode& right);
+
+    void    Build(const lex_map& lexMap);
+    void    BuildTree(size_t node, size_t l, size_t r);
+    void    UpdateTree(size_t node, size_t l, size_t r, size_t leaf);
+    void    UpdateLeaf(const lex_map& lexMap, size_t leaf, size_t begin);
+    size_t  GetLeaf(size_t& line, bool& state) const;
+
+    std::optional<size_t> FindDown(size_t node, size_t l, size_t r, size_t from,
+        int type, bool state, size_t begin, int& count, bool& leafState, size_t& leafBegin) const;
+    std::optional<size_t> FindUp(size_t node, size_t l, size_t r, size_t to,
+        int type, bool state, size_t begin, int& count, bool& leafState, size_t& leafBegin) const;
+    static std::optional<size_t> ScanDown(const lex_map& lexMap, size_t begin, size_t end, size_t from,
+        int type, bool comment, int& count);
+    static std::optional<size_t> ScanUp(const lex_map& lexMap, size_t begin, size_t end,
+        int type, bool comment, int& count);
+
+public:
+    void    Clear() { m_valid = false; m_leaf.clear(); m_tree.clear(); }
+    void    ChangeLine(const lex_map& lexMap, size_t line);
+    void    AddLine(const lex_map& lexMap, size_t line);
+    void    DelLine(const lex_map& lexMap, size_t line);
+
+    //find line with pair bracket for bracket c with count unpaired brackets after/before line
+    std::optional<size_t> FindPair(const lex_map& lexMap, char c, size_t line, int count);
+};
+
+} //namespace _Editor
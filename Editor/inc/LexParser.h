@@ -29,6 +29,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "Console/Types.h"
 #include "WndManager/Invalidate.h"
 #include "utils/SymbolType.h"
+#include "LexPairIndex.h"
 
 #include <string>
 #include <map>
@@ -97,6 +98,22 @@ public:
     inline static const std::string c_TextType{ "Text" };
     static std::map<std::string, LexConfig> s_lexConfig;
 
+    //parser state passed from line to line
+    struct LexState
+    {
+        std::list<char16_t> stringSymbol;
+        bool        cutLine{};
+        size_t      commentOpen{};
+        bool        commentToggled{};
+
+        bool operator==(const LexState& state) const
+        {
+            return cutLine == state.cutLine && commentOpen == state.commentOpen
+                && commentToggled == state.commentToggled && stringSymbol == state.stringSymbol;
+        }
+        bool operator!=(const LexState& state) const { return !(*this == state); }
+    };
+
 protected:
     static std::unordered_map<char16_t, std::pair<char16_t, bool>> s_lexPairs;
 
@@ -123,7 +140,9 @@ protected:
 
     bool        m_showTab{};
 
-    std::map<size_t, std::string> m_lexPosition;
+    lex_map     m_lexPosition;
+    LexPairIndex m_pairIndex;
+    lex_map     m_funcPosition;     //function definitions by line
     
     std::list<char16_t>           m_stringSymbol;
     bool                          m_cutLine{};
@@ -138,6 +157,10 @@ protected:
     
     bool    AddLexem(size_t line, const std::string& lexstr);
     bool    DeleteLexem(size_t line);
+    static void ShiftLines(lex_map& lexMap, size_t line, bool insert);
+
+    std::string ScanFunc(std::u16string_view str);
+    void    SetFunc(size_t line, std::string&& name);
 
     lex_t   SymbolType(char16_t c) const ;
     lex_t   ScanComment(std::u16string_view lexem, size_t& begin, size_t& end);
@@ -156,6 +179,7 @@ public:
     static std::pair<size_t, std::string> GetFileType(const std::filesystem::path& name);
 
     bool    EnableParsing(bool scan)    { return m_scan = scan; }
+    bool    IsParsingEnabled() const    { return m_scan; }
     bool    SetParseStyle(const std::string& style = "");
     std::string GetParseStyle() const   {return m_parseStyle;}
 
@@ -164,12 +188,16 @@ public:
     bool    GetSaveTab() const          {return m_saveTab;}
     size_t  GetTabSize() const          {return m_tabSize;}
 
-    bool    Clear() { m_lexPosition.clear(); return true; }
+    bool    Clear() { m_lexPosition.clear(); m_pairIndex.Clear(); m_funcPosition.clear(); return true; }
+    LexState GetLexState() const;
+    void    SetLexState(const LexState& state);
+    bool    MergeLexPosition(LexParser& parser);
     bool    ScanStr(size_t line, std::string_view str, const std::string& cp);
     bool    GetColor(size_t line, const std::u16string& str, std::vector<color_t>& color, size_t len);
 
     bool    CheckLexPair(const std::u16string& str, size_t& line, size_t& pos);
     bool    GetLexPair(const std::u16string& str, size_t line, char16_t c, size_t& pos);
+    const lex_map& GetFuncList() const  { return m_funcPosition; }
 
     bool    ChangeStr(size_t line, const std::u16string& str, invalidate_t& inv);
     bool    AddStr(size_t line, const std::u16string& str, invalidate_t& inv);
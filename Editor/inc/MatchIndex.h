@@ -0,0 +1,117 @@
+/*
+FreeBSD License
+
+Copyright (c) 2020-2021 vikonix: valeriy.kovalev.software@gmail.com
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include "utils/StrFinder.h"
+
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+
+namespace _Editor
+{
+
+//found substrings in line: position and size
+using line_match_t = std::vector<std::pair<size_t, size_t>>;
+
+//////////////////////////////////////////////////////////////////////////////
+//index of all found substrings in file for current search
+//lines are scanned in background, changed lines are scanned again before use
+class MatchIndex
+{
+public:
+    struct Match
+    {
+        size_t  line;
+        size_t  x;
+        size_t  size;
+    };
+
+    using match_func = std::function<void(size_t line, line_match_t& found)>;
+
+private:
+    std::string                 m_key;
+    match_func                  m_func;
+    std::optional<_Utils::StrFinder> m_finder;
+
+    std::vector<Match>          m_match;    //sorted by line and position
+    std::vector<size_t>         m_dirty;    //sorted lines for scan
+    size_t                      m_scanLine{};
+
+    //not applied shift of matches after added and deleted lines:
+    //lines from m_shiftLine are moved by m_shift,
+    //lines before it and from m_shiftLine + m_shift are deleted for negative shift
+    size_t                      m_shiftLine{};
+    ptrdiff_t                   m_shift{};
+
+    std::vector<Match>::iterator        LineBegin(size_t line);
+    std::vector<Match>::const_iterator  LineBegin(size_t line) const;
+    void    EraseLine(size_t line);
+    void    ShiftDirty(size_t line, bool add);
+    void    InsertLine(size_t line);
+
+public:
+    void    Start(const std::string& key, match_func func, std::optional<_Utils::StrFinder> finder);
+    void    Stop() { m_key.clear(); m_func = nullptr; m_finder.reset(); Clear(); }
+    void    Clear() { m_match.clear(); m_dirty.clear(); m_scanLine = 0; m_shiftLine = 0; m_shift = 0; }
+    void    Truncate(size_t line);
+    //matches get line numbers after file changing, it is needed before search in index
+    void    ApplyShift();
+
+    const std::string&  GetKey() const      {return m_key;}
+    bool    IsActive() const                {return m_func != nullptr;}
+    bool    IsComplete(size_t count) const  {return m_scanLine >= count && m_dirty.empty();}
+    bool    IsScanned(size_t line) const;
+    size_t  GetScanLine() const             {return m_scanLine;}
+    const std::optional<_Utils::StrFinder>& GetFinder() const {return m_finder;}
+
+    //file changing
+    void    ChangeLine(size_t line);
+    void    AddLine(size_t line);
+    void    DelLine(size_t line);
+
+    //scanning
+    bool    ScanDirty();
+    void    ScanLine(size_t line);
+    void    SkipLines(size_t line) {m_scanLine = std::max(m_scanLine, line);}
+
+    size_t  GetCount() const {return m_match.size();}
+    //number of match at position
+    std::optional<size_t>   GetNumber(size_t line, size_t x) const;
+    //first match from position and before line end
+    std::optional<Match>    FindDown(size_t line, size_t x, size_t end) const;
+    //last match before position and not before line end,
+    //inside - match must end before position
+    std::optional<Match>    FindUp(size_t line, size_t x, size_t end, bool inside) const;
+    //all matches from position and before line end
+    std::vector<Match>      GetMatches(size_t line, size_t x, size_t end) const;
+    line_match_t            GetLine(size_t line) const;
+};
+
+} //namespace _Editor
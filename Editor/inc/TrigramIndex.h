@@ -0,0 +1,112 @@
+/*
+FreeBSD License
+
+Copyright (c) 2020-2021 vikonix: valeriy.kovalev.software@gmail.com
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include "FileSearcher.h"
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+
+namespace _Editor
+{
+
+//////////////////////////////////////////////////////////////////////////////
+//trigram index of files for fast search in files,
+//index is built in background thread, stored in user local dir and updated by file size/time.
+//files are added only to the end so posting lists are kept compressed as varint deltas
+//and changed file gets new number while old number is marked as removed
+class TrigramIndex
+{
+    inline static const std::string c_indexDir{ "index" };
+    inline static const std::string c_indexExt{ ".mti" };
+    inline static const uint32_t    c_magic{ 0x3149544d };      //MTI1
+    inline static const uintmax_t   c_maxFileSize{ 0x1000000 }; //bigger files are always scanned
+    inline static const size_t      c_maxTrigrams{ 0x100000 };  //for sort and unique
+
+    struct FileInfo
+    {
+        std::string path;
+        uintmax_t   size{};
+        int64_t     time{};
+        bool        indexed{};
+        bool        removed{};
+    };
+
+    struct Posting
+    {
+        uint32_t    last{};     //last file number
+        std::string data;       //varint deltas of file numbers
+    };
+
+    path_t                                      m_root;
+    path_t                                      m_indexPath;
+
+    std::mutex                                  m_mutex;
+    std::vector<FileInfo>                       m_files;
+    std::unordered_map<std::string, uint32_t>   m_fileMap;  //path to file number
+    std::unordered_map<uint32_t, Posting>       m_postings;
+    size_t                                      m_removed{};
+
+    std::thread                                 m_thread;
+    std::atomic_bool                            m_cancel{ false };
+    std::atomic_bool                            m_updating{ false };
+    bool                                        m_loaded{};
+
+    static uint32_t GetTrigram(uint8_t c1, uint8_t c2, uint8_t c3);
+    static int64_t  GetFileTime(const path_t& file, std::error_code& ec);
+
+    void    Clear();
+    bool    Load();
+    bool    Save();
+    void    UpdateIndex();
+    bool    ScanFile(const path_t& file, ScanBuff& buff, std::vector<uint32_t>& trigrams);
+    void    AddFile(FileInfo&& info, const std::vector<uint32_t>& trigrams);
+    std::vector<uint32_t> GetPosting(uint32_t trigram);
+
+public:
+    TrigramIndex(const path_t& root);
+    ~TrigramIndex() {Stop();}
+
+    const path_t&   GetRoot() const     {return m_root;}
+    bool            IsUpdating() const  {return m_updating;}
+    bool            IsCovered(const path_t& path) const;
+
+    //starts background update if it isn't running
+    void    Update();
+    void    Stop();
+
+    //filter for search skips files that can't contain the string,
+    //empty filter means that the index doesn't help
+    FileSearcher::filter_func GetFilter(const std::u16string& toFind, const std::string& cp, bool checkCase);
+};
+
+} //namespace _Editor
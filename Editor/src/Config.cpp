@@ -338,6 +338,13 @@ bool DialogsConfig::Load(const nlohmann::json& json)
         findList.push_back(var);
     for(auto& var : json[ReplaceKey])
         replaceList.push_back(var);
+    if (json.contains(UseIndexKey))
+        useIndex = json[UseIndexKey];
+    if (json.contains(BinaryKey))
+        scanBinary = json[BinaryKey];
+    if (json.contains(IndexKey))
+        for (auto& var : json[IndexKey])
+            indexList.push_back(var);
 
     return true;
 }
@@ -348,6 +355,9 @@ bool DialogsConfig::Save(nlohmann::json& json) const
     json[MaskKey]       = fileMaskList;
     json[FindKey]       = findList;
     json[ReplaceKey]    = replaceList;
+    json[UseIndexKey]   = useIndex;
+    json[BinaryKey]     = scanBinary;
+    json[IndexKey]      = indexList;
 
     return true;
 }
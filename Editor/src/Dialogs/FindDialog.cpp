@@ -50,6 +50,8 @@ namespace _Editor
 #define ID_FF_PROMPT   (ID_USER + 13)
 #define ID_FF_INMARKED (ID_USER + 14)
 #define ID_FF_CP       (ID_USER + 15)
+#define ID_FF_REGEX    (ID_USER + 16)
+#define ID_FF_WORD     (ID_USER + 17)
 
 FindReplaceVars FindDialog::s_vars;
 
@@ -61,11 +63,12 @@ std::list<control> findDialog
     {CTRL_EDITDROPLIST,                 "",                         ID_FF_SEARCH,   &FindDialog::s_vars.findStr,    15, 1, 52,  7, "Input string for search"},
     {CTRL_STATIC,                       "&Replace with:",           ID_FF_SREPLACE, {},                              1, 2, 14},
     {CTRL_EDITDROPLIST,                 "",                         ID_FF_REPLACE,  &FindDialog::s_vars.replaceStr, 15, 2, 52,  7, "Input string for replace"},
-    {CTRL_CHECK,                        "C&ase sensitive",          2,              &FindDialog::s_vars.checkCase,   1, 4,  0,  0, "Search case sensitive or not"},
-    {CTRL_CHECK,                        "&Whole word",              3,              &FindDialog::s_vars.findWord,    1, 5,  0,  0, "Search whole word or phrase"},
+    {CTRL_CHECK,                        "C&ase sensitive",          ID_FF_CASE,     &FindDialog::s_vars.checkCase,   1, 4,  0,  0, "Search case sensitive or not"},
+    {CTRL_CHECK,                        "&Whole word",              ID_FF_WORD,     &FindDialog::s_vars.findWord,    1, 5,  0,  0, "Search whole word or phrase"},
     {CTRL_CHECK,                        "Restrict in &marked lines",ID_FF_INMARKED, &FindDialog::s_vars.inSelected,  1, 6,  0,  0, "Find/Replace in marked lines only"},
     {CTRL_CHECK,                        "Reverse &direction",       ID_FF_REVERSE,  &FindDialog::s_vars.directionUp,35, 4,  0,  0, "Search in up direction"},
     {CTRL_CHECK,                        "Replace without &prompt",  ID_FF_PROMPT,   &FindDialog::s_vars.noPrompt,   35, 4,  0,  0, "Replace in whole file without prompt"},
+    {CTRL_CHECK,                        "Regular e&xpression",      ID_FF_REGEX,    &FindDialog::s_vars.regex,      35, 5,  0,  0, "Search with regular expression"},
 
     {CTRL_LINE,                         "",                         0,              {},                              1, 8, 66},
     {CTRL_DEFBUTTON | CTRL_ALIGN_RIGHT, "",                         ID_OK,          {},                             43, 9,  0,  0, "Start search process"},
@@ -133,6 +136,13 @@ bool FindDialog::OnActivate()
         GetItem(0)->SetName("Find");
         GetItem(ID_OK)->SetName("Find");
 
+        //search is started only after changing of string
+        m_editor = editor;
+        m_incStr = GetItem(ID_FF_SEARCH)->GetWName();
+        m_incCase = s_vars.checkCase;
+        m_incWord = s_vars.findWord;
+        m_incOff = s_vars.regex || s_vars.directionUp;
+
         GetItem(ID_FF_SREPLACE)->SetMode(CTRL_HIDE);
         GetItem(ID_FF_REPLACE)->SetMode(CTRL_HIDE);
         GetItem(ID_FF_PROMPT)->SetMode(CTRL_HIDE);
@@ -148,6 +158,43 @@ bool FindDialog::OnActivate()
     return true;
 }
 
+bool FindDialog::IsChecked(int id)
+{
+    auto ctrl = std::dynamic_pointer_cast<CtrlCheck>(GetItem(id));
+    return ctrl && ctrl->GetCheck();
+}
+
+input_t FindDialog::EventProc(input_t code)
+{
+    bool time = code == K_TIME;
+    code = Dialog::EventProc(code);
+    if (!m_editor || (code & K_TYPEMASK) == K_CLOSE)
+        return code;
+
+    auto str = GetItem(ID_FF_SEARCH)->GetWName();
+    bool checkCase = IsChecked(ID_FF_CASE);
+    bool word = IsChecked(ID_FF_WORD);
+    //regular expression and reverse search are started only with button
+    bool off = IsChecked(ID_FF_REGEX) || IsChecked(ID_FF_REVERSE);
+
+    if (str != m_incStr || checkCase != m_incCase || word != m_incWord || off != m_incOff)
+    {
+        m_incStr = str;
+        m_incCase = checkCase;
+        m_incWord = word;
+        m_incOff = off;
+
+        s_vars.checkCase = checkCase;
+        s_vars.findWord = word;
+        s_vars.regex = false;
+        m_editor->IncFind(off ? std::u16string{} : str);
+    }
+    else if (time)
+        //search is continued while user does nothing
+        m_editor->IncFindNext();
+
+    return code;
+}
 
 bool FindDialog::OnClose(int id)
 {
@@ -165,6 +212,17 @@ bool FindDialog::OnClose(int id)
                 Refresh();
                 return false;
             }
+            if (auto ctrlRegex = std::dynamic_pointer_cast<CtrlCheck>(GetItem(ID_FF_REGEX)); ctrlRegex && ctrlRegex->GetCheck())
+            {
+                Regex regex(str);
+                if (!regex.IsValid())
+                {
+                    Application::getInstance().SetErrorLine("Regular expression: " + regex.GetError());
+                    SelectItem(ID_FF_SEARCH);
+                    Refresh();
+                    return false;
+                }
+            }
             if (str.size() > 2)
             {
                 ctrlSearch->AddStr(0, str);
@@ -32,6 +32,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "utils/CpConverter.h"
 #include "EditorWnd.h"
 #include "EditorApp.h"
+#include "FileReplacer.h"
 
 using namespace _Utils;
 
@@ -55,6 +56,9 @@ FindFileDialogVars FindFileDialog::s_vars;
 #define ID_FF_PROMPT   (ID_USER + 12)
 #define ID_FF_INMARKED (ID_USER + 13)
 #define ID_FF_CP       (ID_USER + 14)
+#define ID_FF_REGEX    (ID_USER + 15)
+#define ID_FF_INDEX    (ID_USER + 16)
+#define ID_FF_BINARY   (ID_USER + 17)
 
 std::list<control> findFileDialog 
 {
@@ -79,10 +83,13 @@ std::list<control> findFileDialog
     {CTRL_CHECK,                        "&Whole word",                  3,              &FindDialog::s_vars.findWord,       20, 14,  0,  0, "Search whole word or phrase"},
     {CTRL_CHECK,                        "Search in s&ub-directories",   ID_FF_SUBDIR,   &FindFileDialog::s_vars.recursive,  20, 15,  0,  0, "Recursive search in subdirectories or not"},
     {CTRL_CHECK,                        "Search in &opened files only", ID_FF_OPEN,     &FindFileDialog::s_vars.inOpen,     20, 16,  0,  0, "Search just in all opened files"},
-    {CTRL_CHECK,                        "Without &prompt for replace",  ID_FF_PROMPT,   &FindDialog::s_vars.noPrompt,       20, 17,  0,  0, "Replace in all files without prompt"},
+    {CTRL_CHECK,                        "Without &prompt for replace",  ID_FF_PROMPT,   &FindDialog::s_vars.noPrompt,       20, 17,  0,  0, "Replace in all files without prompt and opening them"},
+    {CTRL_CHECK,                        "Regular e&xpression",          ID_FF_REGEX,    &FindDialog::s_vars.regex,          20, 18,  0,  0, "Search with regular expression"},
 
     {CTRL_STATIC,                       "&Encoding:",                   0,              {},                                 54, 13, 14},
-    {CTRL_DROPLIST,                     "",                             ID_FF_CP,       &FileDialog::s_vars.cp,             54, 14, 13,  6, "Select file encoding"}
+    {CTRL_DROPLIST,                     "",                             ID_FF_CP,       &FileDialog::s_vars.cp,             54, 14, 13,  6, "Select file encoding"},
+    {CTRL_CHECK,                        "Use &index",                   ID_FF_INDEX,    &FindFileDialog::s_vars.useIndex,   54, 16,  0,  0, "Skip files by index of directory built in background"},
+    {CTRL_CHECK,                        "&Binary",                      ID_FF_BINARY,   &FindFileDialog::s_vars.binary,     54, 17,  0,  0, "Search in binary files with zero bytes too"}
 };
 
 FindFileDialog::FindFileDialog(bool replace, pos_t x, pos_t y)
@@ -137,6 +144,7 @@ bool FindFileDialog::OnActivate()
         GetItem(ID_FF_SREPLACE)->SetMode(CTRL_HIDE);
         GetItem(ID_FF_REPLACE)->SetMode(CTRL_HIDE);
         GetItem(ID_FF_PROMPT)->SetMode(CTRL_HIDE);
+        GetItem(ID_FF_REGEX)->SetMode(CTRL_HIDE);
 
         pos_t x, y, sizex, sizey;
         auto smask = GetItem(ID_FF_SMASK);
@@ -337,9 +345,13 @@ std::list<control> dlgSearchFile
     {CTRL_BUTTON | CTRL_ALIGN_RIGHT,"Stop",         ID_CANCEL,      {}, 40, 18}
 };
 
-SearchFileDialog::SearchFileDialog(pos_t x, pos_t y)
+SearchFileDialog::SearchFileDialog(EditorWnd* foundWnd, bool replace, pos_t x, pos_t y)
     : Dialog(dlgSearchFile, x, y)
+    , m_foundWnd{foundWnd}
+    , m_replace{replace}
 {
+    if (m_replace)
+        GetItem(0)->SetName("File Replace");
 }
 
 input_t SearchFileDialog::Activate()
@@ -357,85 +369,134 @@ input_t SearchFileDialog::Activate()
     Application::getInstance().SetErrorLine("Wait for files scan. Press any key for cancel.");
     s_foundList.clear();
     s_listPos = 0;
-    [[maybe_unused]]auto rc = ScanDir(path / utf8::utf8to16(m_mask));
+    [[maybe_unused]]auto rc = Search(path / utf8::utf8to16(m_mask));
 
     Hide();
     WndManager::getInstance().SetActiveView(m_activeView);
-    Application::getInstance().SetHelpLine();
+    if (m_summary.empty())
+        Application::getInstance().SetHelpLine();
+    else
+        Application::getInstance().SetHelpLine(m_summary);
 
     return ID_OK;
 }
 
-bool SearchFileDialog::ScanDir(const path_t& path)
+bool SearchFileDialog::Search(const path_t& path)
 {
     //LOG(DEBUG) << __FUNC__ << "path=" << path.u8string();
-    
-    auto sizex = GetItem(ID_SF_PATH)->GetSizeX();
-    std::string dirPath = Directory::CutPath(path / m_mask, sizex);
-    dirPath.resize(sizex, ' ');
-    GetItem(ID_SF_PATH)->SetName(dirPath);
-
-    _Utils::DirectoryList dirList;
 
-    dirList.SetMask(path);
-    dirList.SetMask(m_mask);
-    dirList.Scan();
-    
-    bool putPath{};
+    auto sizex = GetItem(ID_SF_PATH)->GetSizeX();
     auto fList = GetItem(ID_SF_FILELIST);
     auto fListPtr = std::dynamic_pointer_cast<CtrlList>(fList);
 
-    for (auto& file : dirList.GetFileList())
+    FileSearcher::filter_func filter;
+    if (FindFileDialog::s_vars.inOpen)
     {
-        if(!ShowProgress())
-            return false;
+        //windows list is copied for walker thread
+        auto& editorApp = dynamic_cast<EditorApp&>(Application::getInstance());
+        auto files = std::make_shared<std::set<path_t>>(editorApp.GetEditorFiles());
+        filter = [files](const path_t& file) { return files->count(file) != 0; };
+    }
 
-        if (FindFileDialog::s_vars.inOpen)
+    //index is used for plain string only
+    TrigramIndex* index{};
+    if (FindFileDialog::s_vars.useIndex && !(m_replace && m_regex))
+    {
+        auto& editorApp = dynamic_cast<EditorApp&>(Application::getInstance());
+        index = editorApp.GetFileIndex(path.parent_path(), true);
+        if (auto indexFilter = index->GetFilter(m_toFind, m_cp, m_checkCase))
         {
-            auto& app = Application::getInstance();
-            auto& editorApp = dynamic_cast<EditorApp&>(app);
-            auto wnd = editorApp.GetEditorWnd(file.path());
-            if (nullptr == wnd)
-                continue;
+            if (!filter)
+                filter = indexFilter;
+            else
+                filter = [filter, indexFilter](const path_t& file) { return filter(file) && indexFilter(file); };
         }
-        
-        std::string shortPath = Directory::CutPath(file.path(), sizex);
-        shortPath.resize(sizex, ' ');
-        GetItem(ID_SF_PATH)->SetName(shortPath);
+    }
+
+    //all matches are needed only for found window
+    std::unique_ptr<FileSearcher> searcher;
+    FileReplacer* replacer{};
+    if (!m_replace)
+        searcher = std::make_unique<FileSearcher>(m_toFind, m_cp, m_checkCase, m_findWord, m_foundWnd != nullptr);
+    else
+    {
+        auto fileReplacer = std::make_unique<FileReplacer>(m_toFind, m_replaceStr, m_cp, m_checkCase, m_findWord, m_regex);
+        if (!fileReplacer->IsValid())
+        {
+            Application::getInstance().SetErrorLine("Regular expression: " + fileReplacer->GetError());
+            return false;
+        }
+        replacer = fileReplacer.get();
+        searcher = std::move(fileReplacer);
+    }
+    searcher->SetBinary(FindFileDialog::s_vars.binary);
+    searcher->Start(path, m_mask, m_recursive, filter);
+
+    //found files are shown while workers scan others
+    path_t curPath;
+    size_t count{};
+    bool done{};
+    while (!done)
+    {
+        done = searcher->IsDone();
+
+        std::string dirPath = Directory::CutPath(searcher->GetCurPath() / m_mask, sizex);
+        dirPath.resize(sizex, ' ');
+        GetItem(ID_SF_PATH)->SetName(dirPath);
 
-        bool ret = Editor::ScanFile(file.path(), m_toFind, m_cp, m_checkCase, m_findWord, std::bind(&SearchFileDialog::ShowProgress, this));
-        if (ret)
+        auto found = searcher->GetFound();
+        for (auto& [file, n, matches] : found)
         {
-            //found
-            LOG(DEBUG) << "found in file=" << file.path().u8string();
-            s_foundList.emplace_back(file.path());
-            std::string count = "Matched " + std::to_string(s_foundList.size()) + " file(s).";
-            GetItem(ID_SF_COUNT)->SetName(count);
+            LOG(DEBUG) << "found in file=" << file.u8string();
+            if (curPath != file.parent_path())
+            {
+                curPath = file.parent_path();
+                fListPtr->AppendStr(curPath.u8string());
+            }
 
-            if (!putPath)
+            if (!m_foundWnd)
+                fListPtr->AppendStr("  " + file.filename().u8string());
+            else
             {
-                putPath = true;
-                fListPtr->AppendStr(file.path().parent_path().u8string());
+                fListPtr->AppendStr("  " + file.filename().u8string() + " (" + std::to_string(n) + ")");
+                if (!m_replace)
+                    m_foundWnd->AddFoundInFile(file, matches);
+                else
+                    m_foundWnd->AddReplacedFile(file, n);
             }
-            fListPtr->AppendStr("  " + file.path().filename().u8string());
-            fListPtr->SetSelect(fListPtr->GetStrCount() - 1);
         }
-    }
-
-    if (!ShowProgress())
-        return false;
 
-    if(m_recursive)
-        for (auto& dir : dirList.GetDirList())
+        if (!found.empty())
         {
-            if (dir == "..")
-                continue;
-            bool rc = ScanDir(dirList.GetPath() / utf8::utf8to16(dir));
-            if (!rc)
-                return false;
+            count += found.size();
+            fListPtr->SetSelect(fListPtr->GetStrCount() - 1);
+            if (!m_replace)
+                GetItem(ID_SF_COUNT)->SetName("Matched " + std::to_string(count) + " file(s).");
+            else
+                GetItem(ID_SF_COUNT)->SetName("Replaced in " + std::to_string(count) + " file(s).");
         }
 
-    return true;
+        if (!done && !ShowProgress())
+            searcher->Stop();
+    }
+
+    s_foundList = searcher->GetResult();
+
+    //changes are taken for next search
+    if (index)
+        index->Update();
+    if (replacer)
+    {
+        auto failed = replacer->GetFailed();
+        auto summary = "Replaced " + std::to_string(replacer->GetReplaced()) + " match(es) in "
+            + std::to_string(s_foundList.size()) + " of " + std::to_string(replacer->GetScanned()) + " file(s)";
+        if (!failed.empty())
+            summary += ", " + std::to_string(failed.size()) + " file(s) not written";
+        if (m_foundWnd)
+            m_foundWnd->AddReplaceSummary(summary, failed);
+        m_summary = summary;
+    }
+    return !m_cancel;
 }
 
 bool SearchFileDialog::ShowProgress()
@@ -449,7 +510,7 @@ bool SearchFileDialog::ShowProgress()
 
     GetItem(ID_SF_PROGRESS)->SetName(buff);
 
-    auto key = CheckInput(1ms);
+    auto key = CheckInput(50ms);
     if (key)
     {
         m_cancel = true;
@@ -0,0 +1,161 @@
+/*
+FreeBSD License
+
+Copyright (c) 2020-2021 vikonix: valeriy.kovalev.software@gmail.com
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "utfcpp/utf8.h"
+#include "Dialogs/EditorDialogs.h"
+#include "WndManager/DlgControls.h"
+#include "EditorApp.h"
+
+#include <iomanip>
+
+
+namespace _Editor
+{
+
+/////////////////////////////////////////////////////////////////////////////
+#define ID_FL_FILTER    (ID_USER + 1)
+#define ID_FL_LIST      (ID_USER + 2)
+#define ID_FL_COUNT     (ID_USER + 3)
+
+std::string FuncListDialog::s_filter;
+
+std::list<control> dlgFuncList
+{
+    {CTRL_TITLE,                        "Function List", 0,             nullptr,                    1,  0, 70, 21},
+
+    {CTRL_STATIC,                       "&Filter:",     0,              nullptr,                    1,  1,  8},
+    {CTRL_EDIT,                         "",             ID_FL_FILTER,   &FuncListDialog::s_filter,  9,  1, 58,  0, "Input part of function name"},
+    {CTRL_LIST,                         "",             ID_FL_LIST,     (size_t*)nullptr,           0,  2, 68, 16, "Select function"},
+    {CTRL_STATIC,                       "",             ID_FL_COUNT,    nullptr,                    1, 18, 35},
+
+    {CTRL_DEFBUTTON | CTRL_ALIGN_RIGHT, "Goto",         ID_OK,          nullptr,                   47, 18,  0,  0, "Go to selected function"},
+    {CTRL_BUTTON | CTRL_ALIGN_RIGHT,    "Cancel",       ID_CANCEL,      nullptr,                   57, 18}
+};
+
+FuncListDialog::FuncListDialog(const std::map<size_t, std::string>& funcList, size_t line, pos_t x, pos_t y)
+    : Dialog(dlgFuncList, x, y)
+    , m_funcList{ funcList }
+    , m_line{ line }
+{
+}
+
+bool FuncListDialog::OnActivate()
+{
+    if (m_funcList.empty())
+    {
+        BeginPaint();
+        EditorApp::SetErrorLine("No functions found");
+        StopPaint();
+        return false;
+    }
+
+    m_filter = utf8::utf8to16(s_filter);
+    FillList();
+    return true;
+}
+
+size_t FuncListDialog::FillList()
+{
+    auto listPtr = std::dynamic_pointer_cast<CtrlList>(GetItem(ID_FL_LIST));
+    listPtr->Clear();
+    m_lines.clear();
+
+    auto upper = [](std::u16string str) {
+        std::transform(str.begin(), str.end(), str.begin(), [](char16_t c) { return std::towupper(c); });
+        return str;
+    };
+    auto filter = upper(m_filter);
+
+    size_t select{};
+    for (auto& [line, name] : m_funcList)
+    {
+        if (!filter.empty() && upper(utf8::utf8to16(name)).find(filter) == std::u16string::npos)
+            continue;
+
+        if (line <= m_line)
+            select = m_lines.size();
+        m_lines.push_back(line);
+
+        std::stringstream sstr;
+        sstr << std::setw(7) << line + 1 << " " << name;
+        listPtr->AppendStr(sstr.str());
+    }
+
+    if (!m_lines.empty())
+        listPtr->SetSelect(select);
+
+    std::stringstream sstr;
+    sstr << m_lines.size() << " function(s)";
+    GetItem(ID_FL_COUNT)->SetName(sstr.str());
+
+    return m_lines.size();
+}
+
+input_t FuncListDialog::EventProc(input_t code)
+{
+    if (GetSelectedId() == ID_FL_FILTER
+        && (code == K_UP || code == K_DOWN || code == K_PAGEUP || code == K_PAGEDN))
+    {
+        //move in list without leaving filter
+        auto list = GetItem(ID_FL_LIST);
+        list->EventProc(code);
+        list->Refresh();
+        return 0;
+    }
+
+    code = Dialog::EventProc(code);
+    if ((code & K_TYPEMASK) == K_CLOSE)
+        return code;
+
+    auto filter = GetItem(ID_FL_FILTER)->GetWName();
+    if (filter != m_filter)
+    {
+        m_filter = filter;
+        StopPaint();
+        FillList();
+        BeginPaint();
+        GetItem(ID_FL_LIST)->Refresh();
+        GetItem(ID_FL_COUNT)->Refresh();
+    }
+
+    return code;
+}
+
+bool FuncListDialog::OnClose(int id)
+{
+    if (id == ID_OK)
+    {
+        auto listPtr = std::dynamic_pointer_cast<CtrlList>(GetItem(ID_FL_LIST));
+        auto n = listPtr->GetSelected();
+        if (n >= m_lines.size())
+            return false;
+
+        m_line = m_lines[n];
+    }
+    return true;
+}
+
+} //namespace _Editor
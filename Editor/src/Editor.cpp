@@ -33,7 +33,12 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "EditorApp.h"
 
 #include <thread>
+#include <unordered_map>
+#include <atomic>
+#include <clocale>
 #include <condition_variable>
+#include <cstring>
+#include <mutex>
 
 
 namespace _Editor
@@ -226,6 +231,7 @@ bool Editor::Clear()
     m_buffer.Clear();
     m_undoList.Clear();
     m_lexParser.Clear();
+    m_matchIndex.Clear();
     m_curStrBuff.clear();
     m_curStr = STR_NOTDEFINED;
     m_curChanged = false;
@@ -370,6 +376,7 @@ bool Editor::LoadTail()
         strBuff->m_lostData = false;
         m_buffer.m_totalStrCount -= strBuff->GetStrCount();
         strBuff->m_strOffsetList.clear();
+        m_matchIndex.Truncate(m_buffer.m_totalStrCount);
 
         uintmax_t fileOffset{ strBuff->m_fileOffset };
         size_t toRead{ std::min(c_buffsize, static_cast<size_t>(fileSize - fileOffset)) };
@@ -624,6 +631,7 @@ void Editor::SetTab(size_t tabsize)
 { 
     FlushCurStr();
     m_tab = tabsize;
+    m_matchIndex.Clear();
     m_curStrBuff = _GetStr(m_curStr, 0, m_maxStrlen);
 }
 
@@ -703,6 +711,29 @@ std::u16string Editor::_GetStr(size_t line, size_t offset, size_t size)
     return outstr;
 }
 
+size_t Editor::GetColumn(size_t line, size_t pos)
+{
+    //symbol position in file string is converted to column
+    if (line >= m_buffer.GetStrCount())
+        return pos;
+
+    auto str{ m_buffer.GetStr(line) };
+    if (line == 0 && m_bom)
+    {
+        //remove bom
+        str.remove_prefix(3);
+        pos = pos ? pos - 1 : 0;
+    }
+    std::u16string wstr;
+    [[maybe_unused]]bool rc = m_converter->Convert(str, wstr);
+    m_buffer.ReleaseBuff();
+
+    size_t x{};
+    for (size_t i = 0; i < pos; ++i)
+        x = i < wstr.size() && wstr[i] == S_TAB ? (x + m_tab) - (x + m_tab) % m_tab : x + 1;
+    return x;
+}
+
 std::u16string Editor::GetStrForFind(size_t line, bool checkCase, bool fast)
 {
     if (line >= m_buffer.GetStrCount())
@@ -774,6 +805,464 @@ std::u16string Editor::GetStrForFind(size_t line, bool checkCase, bool fast)
     return outstr;
 }
 
+bool Editor::CheckRegex(size_t line, Regex& regex)
+{
+    //check file string without conversion,
+    //regex must be compiled for file code page
+    if (line >= m_buffer.GetStrCount())
+        return false;
+
+    auto str{ m_buffer.GetStr(line) };
+    size_t len{};
+    for (; len < str.size(); ++len)
+    {
+        auto c = static_cast<unsigned char>(str[len]);
+        if (c == S_CR || c == S_LF || c == S_EOF)
+            break;
+        if (c < ' ')
+        {
+            //tabulation or control symbols are replaced in string for find
+            m_buffer.ReleaseBuff();
+            return true;
+        }
+    }
+
+    bool rc = regex.Search(str.substr(0, len));
+    m_buffer.ReleaseBuff();
+
+    return rc;
+}
+
+//string for find has spaces instead of tabs and control symbols,
+//so the longest part without spaces is searched in file data
+static std::u16string GetDataPart(const std::u16string& str)
+{
+    size_t begin{}, size{};
+    for (size_t i = 0, b = 0; i <= str.size(); ++i)
+        if (i == str.size() || str[i] <= ' ')
+        {
+            if (i - b > size)
+            {
+                begin = b;
+                size = i - b;
+            }
+            b = i + 1;
+        }
+
+    return str.substr(begin, size);
+}
+
+std::u16string Editor::GetCaseVariants(char16_t c)
+{
+    //symbols with the same upper case, case depends on locale
+    static std::mutex mapMutex;
+    static std::string mapLocale;
+    static std::unordered_map<char16_t, std::u16string> lowerMap;
+
+    auto upper = static_cast<char16_t>(std::towupper(c));
+    std::u16string symbols{ c };
+    symbols += upper;
+
+    std::unique_lock lock{ mapMutex };
+    if (const char* locale = std::setlocale(LC_CTYPE, nullptr); locale && mapLocale != locale)
+    {
+        lowerMap.clear();
+        for (uint32_t i = 0; i < 0x10000; ++i)
+            if (i < 0xd800 || i > 0xdfff)
+                if (auto u = static_cast<char16_t>(std::towupper(i)); u != i)
+                    lowerMap[u] += static_cast<char16_t>(i);
+        mapLocale = locale;
+    }
+
+    if (auto it = lowerMap.find(upper); it != lowerMap.end())
+        symbols += it->second;
+    return symbols;
+}
+
+std::optional<StrFinder> Editor::MakeStrFinder(std::u16string_view str, bool checkCase, iconvpp::CpConverter& converter)
+{
+    StrFinder finder;
+    for (auto c : str)
+    {
+        if (c >= 0xd800 && c <= 0xdfff)
+            return std::nullopt;
+
+        std::u16string symbols{ checkCase ? std::u16string{ c } : GetCaseVariants(c) };
+        std::vector<std::string> variants;
+        for (auto s : symbols)
+            if (std::string encoded; converter.Convert(std::u16string_view{ &s, 1 }, encoded))
+                variants.push_back(std::move(encoded));
+
+        if (!finder.AddSymbol(std::move(variants)))
+            return std::nullopt;
+    }
+
+    if (finder.Empty())
+        return std::nullopt;
+    return finder;
+}
+
+std::optional<StrFinder> Editor::GetStrFinder(const std::u16string& str, bool checkCase)
+{
+    if (!m_converter)
+        return std::nullopt;
+
+    return MakeStrFinder(GetDataPart(str), checkCase, *m_converter);
+}
+
+std::optional<size_t> Editor::FindStrLine(const StrFinder& finder, size_t line, size_t end, bool up, const std::function<bool(size_t)>& progress)
+{
+    return _FindStrLine([&finder](std::string_view data, size_t from) {
+        return finder.Find(data, from);
+    }, line, end, up, progress);
+}
+
+bool Editor::AddMultiStr(MultiStrFinder& finder, const std::u16string& str, size_t id, bool checkCase,
+    const std::function<bool(char16_t, std::string&)>& encode, bool sameCase)
+{
+    std::vector<std::vector<std::string>> symbols;
+    for (auto c : str)
+    {
+        if (c >= 0xd800 && c <= 0xdfff)
+            return false;
+
+        std::vector<std::string> variants;
+        for (auto s : checkCase ? std::u16string{ c } : GetCaseVariants(c))
+            if (std::string encoded; encode(s, encoded))
+                variants.push_back(std::move(encoded));
+        symbols.push_back(std::move(variants));
+    }
+
+    if (finder.AddString(symbols, id))
+        return true;
+    if (checkCase || !sameCase)
+        return false;
+
+    //too many variants, only the same case in whole string
+    bool rc{};
+    for (bool upper : {true, false})
+    {
+        std::string encoded;
+        bool converted{ true };
+        for (auto c : str)
+        {
+            std::string symbol;
+            auto s = static_cast<char16_t>(upper ? std::towupper(c) : std::towlower(c));
+            if (converted = encode(s, symbol); !converted)
+                break;
+            encoded += symbol;
+        }
+        if (converted && finder.AddString(encoded, id))
+            rc = true;
+    }
+    return rc;
+}
+
+std::optional<MultiStrFinder> Editor::GetMultiStrFinder(const std::vector<std::u16string>& strs, bool checkCase)
+{
+    if (!m_converter)
+        return std::nullopt;
+
+    auto encode = [this](char16_t c, std::string& encoded) {
+        return m_converter->Convert(c, encoded);
+    };
+
+    MultiStrFinder finder{ !checkCase };
+    for (size_t i = 0; i < strs.size(); ++i)
+    {
+        //every string must be found in data, so only all case variants are used
+        auto part = GetDataPart(strs[i]);
+        if (part.empty() || !AddMultiStr(finder, part, i, checkCase, encode, false))
+            return std::nullopt;
+    }
+
+    if (!finder.Build())
+        return std::nullopt;
+    return finder;
+}
+
+std::optional<size_t> Editor::FindStrLine(const MultiStrFinder& finder, size_t line, size_t end, bool up, const std::function<bool(size_t)>& progress)
+{
+    return _FindStrLine([&finder](std::string_view data, size_t from) {
+        return finder.Find(data, from);
+    }, line, end, up, progress);
+}
+
+std::optional<size_t> Editor::_FindStrLine(const std::function<size_t(std::string_view, size_t)>& find,
+    size_t line, size_t end, bool up, const std::function<bool(size_t)>& progress)
+{
+    //search directly in block data, lines are calculated only for found position
+    //down: [line, end), up: [end, line]
+    if (up ? line < end : line >= end)
+        return std::nullopt;
+
+    using buff_it = decltype(m_buffer.m_buffList)::iterator;
+    struct FindBlock
+    {
+        buff_it             it;
+        size_t              first;  //first line of block
+        size_t              begin;  //lines [begin, last) in block
+        size_t              last;
+        std::string_view    data{};
+        size_t              pos{};
+        size_t              found{ StrFinder::npos };
+    };
+
+    size_t n{ line };
+    auto buff = m_buffer.GetBuff(n);
+    m_buffer.ReleaseBuff();
+    if (!buff)
+        return line;
+
+    //blocks in search order
+    buff_it it{ *buff };
+    size_t first{ line - n };
+    bool last{};
+    auto nextBlock = [&]() -> std::optional<FindBlock> {
+        while (!last)
+        {
+            auto cur = it;
+            size_t curFirst = first;
+            size_t count = (*it)->GetStrCount();
+            size_t b = std::max(first, up ? end : line);
+            size_t e = std::min(first + count, up ? line + 1 : end);
+
+            if (up)
+            {
+                last = first <= end || it == m_buffer.m_buffList.begin();
+                if (!last)
+                    first -= (*--it)->GetStrCount();
+            }
+            else
+            {
+                first += count;
+                last = first >= end || ++it == m_buffer.m_buffList.end();
+            }
+
+            if (b < e)
+                return FindBlock{ cur, curFirst, b - curFirst, e - curFirst };
+        }
+        return std::nullopt;
+    };
+
+    //only main thread works with buffer pool
+    auto acquire = [this](FindBlock& block) -> bool {
+        auto& strBuff = **block.it;
+        block.pos = strBuff.GetStrOffset(block.begin);
+
+        bool rc = strBuff.GetBuff() != nullptr;
+        if (rc && strBuff.m_lostData)
+        {
+            rc = m_buffer.LoadBuff(strBuff.m_fileOffset, strBuff.GetBuffSize(), strBuff.m_buff);
+            if (rc)
+                strBuff.m_lostData = false;
+            else
+                strBuff.ReleaseBuff();
+        }
+        if (!rc)
+        {
+            //check by lines
+            block.found = block.pos;
+            return false;
+        }
+        block.data = { strBuff.m_buff->c_str(), strBuff.GetStrOffset(block.last) };
+        return true;
+    };
+    auto release = [](FindBlock& block) {
+        if (!block.data.empty())
+            (*block.it)->ReleaseBuff();
+        block.data = {};
+    };
+    auto search = [&find, up](FindBlock& block) {
+        size_t pos{ block.pos };
+        while ((pos = find(block.data, pos)) != StrFinder::npos)
+        {
+            block.found = pos++;
+            if (!up)
+                break;
+        }
+    };
+    auto foundLine = [](const FindBlock& block) -> size_t {
+        auto& offsets = (*block.it)->m_strOffsetList;
+        return block.first + std::distance(offsets.cbegin(), std::upper_bound(offsets.cbegin(), offsets.cend(), block.found));
+    };
+
+    //the nearest blocks are checked in this thread
+    std::optional<FindBlock> block;
+    for (size_t i = 0; i < c_findNearBlocks && (block = nextBlock()); ++i)
+    {
+        if (acquire(*block))
+        {
+            search(*block);
+            release(*block);
+        }
+        if (block->found != StrFinder::npos)
+            return foundLine(*block);
+    }
+    if (!block)
+        return std::nullopt;
+
+    std::vector<FindBlock> blocks;
+    while (auto next = nextBlock())
+        blocks.push_back(*next);
+    if (blocks.empty())
+        return std::nullopt;
+
+    //other blocks are checked by workers, main thread acquires and releases blocks
+    std::mutex mutex;
+    std::condition_variable cvReady;
+    std::condition_variable cvDone;
+    std::vector<char> done(blocks.size());
+    size_t ready{};
+    size_t next{};
+    bool stop{};
+    std::atomic<size_t> found{ StrFinder::npos };//index of the nearest block with string
+    std::atomic_bool cancel{};
+
+    auto setFound = [&found](size_t i) {
+        size_t cur{ found };
+        while (i < cur && !found.compare_exchange_weak(cur, i));
+    };
+
+    auto worker = [&]() {
+        std::unique_lock lock{ mutex };
+        while (1)
+        {
+            cvReady.wait(lock, [&] { return stop || next < ready; });
+            if (next >= ready)
+                return;
+
+            size_t i = next++;
+            lock.unlock();
+            auto& block = blocks[i];
+            if (!cancel && i < found && block.found == StrFinder::npos)
+                search(block);
+            if (block.found != StrFinder::npos)
+                setFound(i);
+            lock.lock();
+
+            done[i] = 1;
+            cvDone.notify_one();
+        }
+    };
+
+    size_t threads = std::min<size_t>(blocks.size(), std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<std::thread> pool;
+    for (size_t i = 0; i < threads; ++i)
+        pool.emplace_back(worker);
+
+    size_t released{};
+    auto time = std::chrono::steady_clock::now();
+    std::unique_lock lock{ mutex };
+    while (1)
+    {
+        bool added{};
+        while (ready < blocks.size() && ready - released < threads * c_findBlocksPerThread && ready < found && !cancel)
+        {
+            if (!acquire(blocks[ready]))
+                setFound(ready);
+            ++ready;
+            added = true;
+        }
+        if (added)
+            cvReady.notify_all();
+
+        while (released < ready && done[released])
+            release(blocks[released++]);
+
+        if (cancel || released == blocks.size() || (found != StrFinder::npos && released > found))
+            break;
+
+        cvDone.wait_for(lock, 1ms);
+
+        if (auto now = std::chrono::steady_clock::now(); now - time > 20ms)
+        {
+            time = now;
+            auto& cur = blocks[std::min(released, blocks.size() - 1)];
+            lock.unlock();
+            if (progress && progress(cur.first + cur.begin))
+                cancel = true;
+            lock.lock();
+        }
+    }
+
+    stop = true;
+    lock.unlock();
+    cvReady.notify_all();
+    for (auto& thread : pool)
+        thread.join();
+
+    for (; released < ready; ++released)
+        release(blocks[released]);
+
+    if (cancel || found == StrFinder::npos)
+        return std::nullopt;
+    return foundLine(blocks[found]);
+}
+
+bool Editor::SetMatchIndex(const std::string& key, MatchIndex::match_func func, std::optional<StrFinder> finder)
+{
+    if (m_matchIndex.IsActive() && m_matchIndex.GetKey() == key)
+        return true;
+
+    LOG(DEBUG) << "SetMatchIndex key=" << key;
+    m_matchIndex.Start(key, func, std::move(finder));
+    return true;
+}
+
+bool Editor::UpdateMatchIndex(const std::function<bool()>& stop)
+{
+    //scan in time when user does nothing
+    if (!m_matchIndex.IsActive())
+        return false;
+
+    FlushCurStr();
+    bool changed = m_matchIndex.ScanDirty();
+
+    size_t count{ GetStrCount() };
+    size_t line{ m_matchIndex.GetScanLine() };
+    while (line < count)
+    {
+        size_t end{ std::min(line + c_matchIndexStep, count) };
+        auto& finder = m_matchIndex.GetFinder();
+        while (line < end)
+        {
+            if (finder)
+            {
+                //skip lines without string
+                auto found = FindStrLine(*finder, line, end, false, nullptr);
+                if (!found)
+                    break;
+                line = *found;
+            }
+            m_matchIndex.ScanLine(line++);
+        }
+        line = end;
+        m_matchIndex.SkipLines(line);
+        changed = true;
+
+        if (stop && stop())
+            break;
+    }
+
+    return changed;
+}
+
+const MatchIndex* Editor::GetMatchIndex(const std::string& key, bool flush)
+{
+    if (!m_matchIndex.IsActive() || m_matchIndex.GetKey() != key)
+        return nullptr;
+
+    if (flush)
+    {
+        //changed lines are checked here
+        FlushCurStr();
+        m_matchIndex.ScanDirty();
+    }
+    else
+        m_matchIndex.ApplyShift();
+    return &m_matchIndex;
+}
 
 bool Editor::ConvertStr(const std::u16string& str, std::string& buff) const
 {
@@ -846,6 +1335,7 @@ bool Editor::ChangeStr(size_t n, const std::u16string& wstr)
     std::string str;
     bool rc = ConvertStr(wstr, str);
     rc = m_buffer.ChangeStr(n, str);
+    m_matchIndex.ChangeLine(n);
 
     return rc;
 }
@@ -903,6 +1393,7 @@ bool Editor::_AddStr(size_t n, const std::u16string& wstr)
     std::string str;
     bool rc = ConvertStr(wstr, str);
     rc = m_buffer.AddStr(n, str);
+    m_matchIndex.AddLine(n);
 
     return rc;
 }
@@ -1125,6 +1616,7 @@ bool Editor::DelLine(bool save, size_t line, size_t count)
         --m_curStr;
 
     bool rc = m_buffer.DelStr(line);
+    m_matchIndex.DelLine(line);
     invalidate_t inv;
     m_lexParser.DelStr(line, inv);
     InvalidateWnd(line, inv);
@@ -1132,6 +1624,7 @@ bool Editor::DelLine(bool save, size_t line, size_t count)
     while (count-- > 1)
     {
         rc = m_buffer.DelStr(--line);
+        m_matchIndex.DelLine(line);
         m_lexParser.DelStr(line, inv);
         InvalidateWnd(line, invalidate_t::del);
     }
@@ -1307,6 +1800,31 @@ bool Editor::ReplaceSubstr(bool save, size_t line, size_t pos, size_t len, const
     return true;
 }
 
+bool Editor::ReplaceLine(bool save, size_t line, const line_replace_t& replace)
+{
+    if (line >= GetStrCount() || replace.empty())
+        return true;
+
+    //all substrings are replaced as one substring from first to last
+    size_t first{ std::get<0>(replace.front()) };
+    size_t len{ std::get<0>(replace.back()) + std::get<1>(replace.back()) - first };
+
+    SetCurStr(line);
+    if (first + len > m_curStrBuff.size())
+        return false;
+
+    std::u16string substr;
+    size_t pos{ first };
+    for (auto& [x, size, str] : replace)
+    {
+        substr.append(m_curStrBuff, pos, x - pos);
+        substr += str;
+        pos = x + size;
+    }
+
+    return ReplaceSubstr(save, line, first, len, substr);
+}
+
 bool Editor::Indent(bool save, size_t line, size_t pos, size_t len, size_t n)
 {
     if (line >= GetStrCount())
@@ -1752,14 +2270,126 @@ bool Editor::SetParseStyle(const std::string& style)
         m_tab = m_lexParser.GetTabSize();
         m_saveTab = m_lexParser.GetSaveTab();
 
+        if (m_fileSize > MAX_PARSED_SIZE)
+            m_lexParser.EnableParsing(false);
+
         FlushCurStr();
-        for (size_t n = 0; n < GetStrCount(); ++n)
+        return ParseBuffer();
+    }
+    
+    return true;
+}
+
+bool Editor::ParseBuffer()
+{
+    if (!m_lexParser.IsParsingEnabled() || m_buffer.m_buffList.empty())
+        return true;
+
+    //every block is parsed by own parser copy in parallel
+    //if parser state at the end of previous block differs from assumed
+    //then block will be parsed again in main thread
+    struct LexBlock
+    {
+        size_t                  firstLine{};
+        std::string             data;
+        std::vector<uint32_t>   strOffset;
+        LexParser               parser;
+        LexParser::LexState     beginState;
+    };
+
+    std::atomic_bool cancel{};
+    auto parse = [this, &cancel](LexBlock& block) {
+        block.parser.Clear();
+        block.parser.SetLexState(block.beginState);
+
+        std::string_view data{ block.data };
+        uint32_t begin{};
+        for (size_t n = 0; n < block.strOffset.size() && !cancel; ++n)
         {
-            auto str = m_buffer.GetStr(n);
-            m_lexParser.ScanStr(n, str, m_cp);
+            block.parser.ScanStr(block.firstLine + n, data.substr(begin, block.strOffset[n] - begin), m_cp);
+            begin = block.strOffset[n];
         }
+    };
+
+    //buffer pool is not thread safe so copy all strings here
+    std::vector<LexBlock> blocks;
+    blocks.reserve(m_buffer.m_buffList.size());
+    size_t line{};
+    for (auto& buff : m_buffer.m_buffList)
+    {
+        auto& block = blocks.emplace_back(LexBlock{ line, {}, {}, m_lexParser, {} });
+        size_t count = buff->GetStrCount();
+        block.data.reserve(buff->GetBuffSize());
+        block.strOffset.reserve(count);
+        for (size_t n = 0; n < count; ++n)
+        {
+            block.data += m_buffer.GetStr(line + n);
+            block.strOffset.push_back(static_cast<uint32_t>(block.data.size()));
+        }
+        line += count;
     }
-    
+    blocks.front().beginState = m_lexParser.GetLexState();
+
+    if (blocks.size() > 1)
+    {
+        std::atomic<size_t> next{};
+        std::atomic<size_t> done{};
+        auto worker = [&]() {
+            for (size_t i; !cancel && (i = next++) < blocks.size(); ++done)
+                parse(blocks[i]);
+        };
+
+        size_t threads = std::min<size_t>(blocks.size(), std::max(1u, std::thread::hardware_concurrency()));
+        std::vector<std::thread> pool;
+        for (size_t i = 0; i < threads; ++i)
+            pool.emplace_back(worker);
+
+        size_t percent{};
+        while (done < blocks.size())
+        {
+            if (WndManager::getInstance().CheckInput(1ms))
+            {
+                cancel = true;
+                break;
+            }
+
+            size_t pr = done * 100 / blocks.size();
+            if (pr != percent)
+            {
+                percent = pr;
+                EditorApp::ShowProgressBar(pr);
+            }
+        }
+
+        for (auto& thread : pool)
+            thread.join();
+
+        EditorApp::ShowProgressBar();
+    }
+
+    if (cancel)
+    {
+        LOG(DEBUG) << "Parsing canceled";
+        m_lexParser.Clear();
+        m_lexParser.EnableParsing(false);
+        EditorApp::SetErrorLine("Parsing canceled");
+        return false;
+    }
+
+    auto state = blocks.front().beginState;
+    for (auto& block : blocks)
+    {
+        if (block.beginState != state || blocks.size() == 1)
+        {
+            block.beginState = state;
+            parse(block);
+        }
+        state = block.parser.GetLexState();
+        m_lexParser.MergeLexPosition(block.parser);
+    }
+    m_lexParser.SetLexState(state);
+
+    EditorApp::SetHelpLine("Ready", stat_color::grayed);
     return true;
 }
 
@@ -1796,6 +2426,203 @@ bool Editor::IsFileInMemory()
 }
 
 bool Editor::ScanFile(const std::filesystem::path& file, const std::u16string& toFind, const std::string& cp, bool checkCase, bool findWord, progress_func func)
+{
+    ScanBuff buff;
+    return ScanFile(file, toFind, cp, checkCase, findWord, buff, func);
+}
+
+void ScanBuff::SetCp(const std::string& newCp)
+{
+    //buffers are allocated only for first file
+    if (!converter || cp != newCp)
+    {
+        cp = newCp;
+        converter = std::make_shared<iconvpp::CpConverter>(cp);
+
+        //all code pages from list are UTF-8 or one byte
+        auto cpList = iconvpp::CpConverter::GetCpList();
+        rawData = std::find(cpList.cbegin(), cpList.cend(), cp) != cpList.cend();
+    }
+    if (buff.size() != c_scanBuffSize)
+        buff.resize(c_scanBuffSize);
+}
+
+//symbols before found substring kept in match string
+constexpr size_t c_matchStrHead{ c_maxMatchStr / 4 };
+
+//line ends are counted as in isEol, CR LF is one line end
+template<typename It>
+static size_t CountEol(It first, It last, bool& cr)
+{
+    size_t count{};
+    for (; first != last; ++first)
+    {
+        if (*first == '\r' || (*first == '\n' && !cr))
+            ++count;
+        cr = *first == '\r';
+    }
+    return count;
+}
+
+//file in UTF-8 or one byte code page is searched in raw data,
+//only strings with found substring are converted
+static bool ScanFileData(std::ifstream& fileStream, const StrFinder& finder, size_t findSize, bool utf8, bool findWord, bool binary,
+    ScanBuff& buff, const std::function<bool()>& func, std::vector<FileMatch>* found)
+{
+    auto& converter = *buff.converter;
+    auto& data = buff.buff;
+    auto& u16buff = buff.u16buff;
+
+    size_t line{};  //line number of data begin
+    bool cr{};      //last counted symbol is CR
+    size_t keep{};  //not full last string is moved to data begin
+    size_t lineX{}; //position of data begin in long string
+    std::u16string lineTail;
+    char16_t lineChar{};
+
+    //symbols around found substring for whole word check
+    auto prevSymbol = [&](std::string_view str, size_t begin, size_t pos) -> char16_t {
+        if (pos == begin)
+            return begin == 0 && lineX ? lineChar : ' ';
+        size_t p{ pos - 1 };
+        while (utf8 && p > begin && pos - p < 4 && (str[p] & 0xc0) == 0x80)
+            --p;
+        converter.Convert(str.substr(p, pos - p), u16buff);
+        return u16buff.empty() ? ' ' : u16buff.back();
+    };
+    auto nextSymbol = [&](std::string_view str, size_t pos, size_t end) -> char16_t {
+        if (pos == end)
+            return ' ';
+        size_t size{ 1 };
+        if (auto c = static_cast<unsigned char>(str[pos]); utf8 && c >= 0xc0)
+            size = c >= 0xf0 ? 4 : c >= 0xe0 ? 3 : 2;
+        converter.Convert(str.substr(pos, std::min(size, end - pos)), u16buff);
+        return u16buff.empty() ? ' ' : u16buff.front();
+    };
+
+    for (bool first{ true };; first = false)
+    {
+        fileStream.read(data.data() + keep, data.size() - keep);
+        auto read = static_cast<size_t>(fileStream.gcount());
+        if (read == 0)
+            break;
+        bool eof = fileStream.eof();
+
+        std::string_view str{ data.data(), keep + read };
+        if (first && !binary && IsBinaryData(str))
+            return false;
+
+        //last not full string is searched with next data
+        size_t last{ str.size() };
+        if (!eof)
+        {
+            auto eol = str.find_last_of("\r\n");
+            if (eol != std::string_view::npos && str.size() - eol - 1 < str.size() / 2)
+                last = eol + 1;
+            else
+            {
+                last = str.size() - std::min(str.size() / 2, findSize * 4);
+                while (utf8 && last > 0 && (str[last] & 0xc0) == 0x80)
+                    --last;
+            }
+        }
+
+        auto isEol = [](char c) { return c == '\n' || c == '\r'; };
+        size_t linePos{};   //lines are counted before this position
+        size_t begin{};     //string of previous found
+        size_t end{};
+        size_t x{};         //position of previous found in its string
+        size_t xPos{};
+        for (size_t pos{}; (pos = finder.Find(str, pos)) != StrFinder::npos && pos < last;)
+        {
+            size_t len = finder.Compare(str, pos);
+            if (pos >= end)
+            {
+                //long strings are scanned only once
+                auto rit = std::find_if(str.crbegin() + (str.size() - pos), str.crend() - end, isEol);
+                begin = std::distance(str.cbegin(), rit.base());
+                end = std::distance(str.cbegin(), std::find_if(str.cbegin() + pos + len, str.cend(), isEol));
+                x = begin ? 0 : lineX;
+                xPos = begin;
+            }
+
+            if (findWord
+                && (GetSymbolType(prevSymbol(str, begin, pos)) == symbol_t::alnum
+                || GetSymbolType(nextSymbol(str, pos + len, end)) == symbol_t::alnum))
+            {
+                ++pos;
+                continue;
+            }
+
+            if (!found)
+                return true;
+
+            line += CountEol(str.cbegin() + linePos, str.cbegin() + pos, cr);
+            linePos = pos;
+
+            converter.Convert(str.substr(xPos, pos - xPos), u16buff);
+            x += u16buff.size();
+            xPos = pos;
+
+            //part of string around found substring
+            size_t from = pos - std::min(pos - begin, c_matchStrHead * 4);
+            while (utf8 && from > begin && (str[from] & 0xc0) == 0x80)
+                --from;
+            converter.Convert(str.substr(from, pos - from), u16buff);
+            std::u16string matchStr;
+            if (from == begin && !begin && lineX)
+                matchStr = lineTail;
+            matchStr += u16buff;
+            if (matchStr.size() > c_matchStrHead)
+                matchStr.erase(0, matchStr.size() - c_matchStrHead);
+            size_t head{ matchStr.size() };
+
+            size_t to = pos + std::min(end - pos, (c_maxMatchStr - head) * 4);
+            while (utf8 && to < end && (str[to] & 0xc0) == 0x80)
+                --to;
+            converter.Convert(str.substr(pos, to - pos), u16buff);
+            matchStr += u16buff.substr(0, c_maxMatchStr - head);
+            found->push_back({ line, x, findSize, x - head, std::move(matchStr) });
+            if (found->size() >= c_maxFileMatches)
+                return true;
+
+            pos += len;
+        }
+
+        if (eof)
+            break;
+
+        line += CountEol(str.cbegin() + linePos, str.cbegin() + last, cr);
+        if (found || findWord)
+        {
+            //string is continued in next data
+            auto rit = std::find_if(str.crbegin() + (str.size() - last), str.crend(), isEol);
+            size_t begin = std::distance(str.cbegin(), rit.base());
+            converter.Convert(str.substr(begin, last - begin), u16buff);
+            if (begin || !lineX)
+            {
+                lineX = 0;
+                lineTail.clear();
+            }
+            lineX += u16buff.size();
+            lineTail += u16buff;
+            if (lineTail.size() > c_matchStrHead)
+                lineTail.erase(0, lineTail.size() - c_matchStrHead);
+            if (!u16buff.empty())
+                lineChar = u16buff.back();
+        }
+
+        keep = str.size() - last;
+        std::memmove(data.data(), data.data() + last, keep);
+
+        if (func && !func())
+            return false;
+    }
+
+    return found && !found->empty();
+}
+
+bool Editor::ScanFile(const std::filesystem::path& file, const std::u16string& toFind, const std::string& cp, bool checkCase, bool findWord, ScanBuff& buff, progress_func func, std::vector<FileMatch>* found, bool binary)
 {
     try
     {
@@ -1816,93 +2643,108 @@ bool Editor::ScanFile(const std::filesystem::path& file, const std::u16string& t
         );
     }
 
-    auto fileSize = std::filesystem::file_size(file);
-
-    //LOG(DEBUG) << __FUNC__ << " path=" << file.u8string() << " size=" << fileSize;
-    if (0 == fileSize)
+    std::ifstream fileStream{ file, std::ios::binary };
+    if (!fileStream)
         return false;
 
-    uintmax_t fileOffset{};
+    buff.SetCp(cp);
 
-    CoReadFile rfile(file, cp, !checkCase);
-    std::u16string prevBuff;
+    if (buff.rawData)
+        if (auto finder = MakeStrFinder(toFind, checkCase, *buff.converter))
+            return ScanFileData(fileStream, *finder, findSize, cp == "UTF-8", findWord, binary, buff, func, found);
 
-    try
+    auto& u16buff = buff.u16buff;
+    auto& prevBuff = buff.prevBuff;
+    prevBuff.clear();
+
+    //line number of buffer begin
+    size_t line{};
+    bool cr{};
+    auto isEol = [](char16_t c) { return c == '\n' || c == '\r'; };
+
+    searcher_t searcher(find.cbegin(), find.cend());
+    for (bool first{ true };; first = false)
     {
-        for (;;)
-        {
-            auto [_, read, eof, u16buff] = rfile.Wait();
-            if (read == 0)
-                break;
+        fileStream.read(buff.buff.data(), buff.buff.size());
+        auto read = static_cast<size_t>(fileStream.gcount());
+        if (read == 0)
+            break;
+        bool eof = fileStream.eof();
+        if (first && !binary && IsBinaryData({ buff.buff.data(), read }))
+            return false;
 
-            if (!prevBuff.empty())
-                u16buff->insert(0, prevBuff);
+        [[maybe_unused]] bool rc = buff.converter->Convert(std::string_view(buff.buff.data(), read), u16buff);
+        if (!prevBuff.empty())
+            u16buff.insert(0, prevBuff);
 
-            searcher_t searcher(find.cbegin(), find.cend());
-            auto itBegin = u16buff->cbegin();
-            while (itBegin != u16buff->cend())
-            {
-                auto itFound = std::search(itBegin, u16buff->cend(), searcher);
-                if (itFound != u16buff->cend())
-                {
-                    if (!findWord)
-                    {
-                        rfile.Cancel();
-                        return true;
-                    }
-                    else
-                    {
+        //original string is kept for found line
+        auto& findBuff = checkCase ? u16buff : buff.upperBuff;
+        if (!checkCase)
+        {
+            findBuff.resize(u16buff.size());
+            std::transform(u16buff.cbegin(), u16buff.cend(), findBuff.begin(),
+                [](char16_t c) { return std::towupper(c); }
+            );
+        }
 
-                        if ((itFound == u16buff->cbegin() || GetSymbolType(*(itFound - 1)) != symbol_t::alnum)
-                            && (itFound + findSize == u16buff->cend() || GetSymbolType(*(itFound + findSize)) != symbol_t::alnum))
-                        {
-                            rfile.Cancel();
-                            return true;
-                        }
-                    }
-                    itBegin = itFound + 1;
-                }
-                else
-                    break;
-            }
-            fileOffset += read;
+        //last not full string is searched with next buffer
+        size_t size{};
+        if (!eof)
+        {
+            auto rit = std::find_if(u16buff.crbegin(), u16buff.crend(), isEol);
+            size = std::distance(u16buff.crbegin(), rit);
+            if (rit == u16buff.crend() || size >= u16buff.size() / 2)
+                size = 0;
+        }
+        auto findEnd = findBuff.cend() - size;
 
-            prevBuff.clear();
-            if (eof)
+        size_t linePos{};
+        auto itBegin = findBuff.cbegin();
+        while (itBegin < findEnd)
+        {
+            auto itFound = std::search(itBegin, findBuff.cend(), searcher);
+            if (itFound >= findEnd)
                 break;
 
-            for (auto rit = u16buff->crbegin(); rit != u16buff->crend(); ++rit)
+            if (!findWord
+                || ((itFound == findBuff.cbegin() || GetSymbolType(*(itFound - 1)) != symbol_t::alnum)
+                && (itFound + findSize == findBuff.cend() || GetSymbolType(*(itFound + findSize)) != symbol_t::alnum)))
             {
-                if (*rit < ' ')
-                {
-                    //save last not full string
-                    auto size = std::distance(u16buff->crbegin(), rit);
-                    prevBuff.resize(size);
-                    std::copy_n(std::prev(u16buff->cend(), size), size, prevBuff.begin());
-                    break;
-                }
-            }
-
-            rfile.Next();
-            if (func)
-            {
-                auto ret = func();
-                if (!ret)
-                {
-                    rfile.Cancel();
-                    return false;
-                }
+                if (!found)
+                    return true;
+
+                size_t pos = std::distance(findBuff.cbegin(), itFound);
+                line += CountEol(u16buff.cbegin() + linePos, u16buff.cbegin() + pos, cr);
+                linePos = pos;
+
+                auto begin = std::find_if(u16buff.crbegin() + (u16buff.size() - pos), u16buff.crend(), isEol).base();
+                auto end = std::find_if(u16buff.cbegin() + pos, u16buff.cend(), isEol);
+                size_t x = std::distance(begin, u16buff.cbegin() + pos);
+                size_t head{ std::min(x, c_matchStrHead) };
+                auto from = u16buff.cbegin() + pos - head;
+                found->push_back({ line, x, findSize, x - head, std::u16string(from, from + std::min<size_t>(end - from, c_maxMatchStr)) });
+                if (found->size() >= c_maxFileMatches)
+                    return true;
+
+                itBegin = itFound + findSize;
             }
+            else
+                itBegin = itFound + 1;
         }
-    }
-    catch (...)
-    {
-        _assert(0);
-    }
 
-    _assert(fileSize == fileOffset);
+        prevBuff.clear();
+        if (eof)
+            break;
+
+        //save last not full string
+        prevBuff.assign(u16buff.cend() - size, u16buff.cend());
+        line += CountEol(u16buff.cbegin() + linePos, u16buff.cend() - size, cr);
+
+        if (func && !func())
+            return false;
+    }
 
-    return false;
+    return found && !found->empty();
 }
 
 } //namespace _Editor
@@ -53,6 +53,7 @@ bool EditorApp::Init()
 void EditorApp::Deinit()
 {
     CloseAllWindows();
+    m_fileIndexes.clear();
     Application::Deinit();
 }
 
@@ -238,6 +239,61 @@ Wnd* EditorApp::GetEditorWnd(std::filesystem::path path)
     return nullptr;
 }
 
+std::set<std::filesystem::path> EditorApp::GetEditorFiles()
+{
+    std::set<std::filesystem::path> files;
+    for (auto& [ptr, wnd] : m_editors)
+        files.insert(wnd->GetFilePath());
+    return files;
+}
+
+EditorWnd* EditorApp::GetFoundWnd(bool replace)
+{
+    std::filesystem::path path{ FileDialog::s_vars.path };
+    std::u16string title;
+    if (!replace)
+        title = u"Search '" + FindDialog::s_vars.findStrW + u"'";
+    else
+        title = u"Replace '" + FindDialog::s_vars.findStrW + u"' with '" + FindDialog::s_vars.replaceStrW + u"'";
+    title += u" in " + utf8::utf8to16((path / FileDialog::s_vars.file).u8string());
+
+    //the same window is used for each search
+    for (auto& [ptr, wnd] : m_editors)
+    {
+        if (wnd->IsFoundWnd())
+        {
+            WndManager::getInstance().SetTopWnd(ptr);
+            wnd->StartFoundInFiles(title);
+            return wnd.get();
+        }
+    }
+
+    auto editor = std::make_shared<EditorWnd>();
+    editor->Show(true, -1);
+    if (!editor->SetFileName(path / c_foundWndName, true))
+        return nullptr;
+
+    m_editors[editor.get()] = editor;
+    editor->StartFoundInFiles(title);
+    return editor.get();
+}
+
+TrigramIndex* EditorApp::GetFileIndex(const std::filesystem::path& path, bool create)
+{
+    for (auto& index : m_fileIndexes)
+        if (index->IsCovered(path))
+            return index.get();
+
+    if (!create)
+        return nullptr;
+
+    //new index is built in background and used for next search
+    auto index = std::make_unique<TrigramIndex>(path);
+    index->Update();
+    m_fileIndexes.push_back(std::move(index));
+    return m_fileIndexes.back().get();
+}
+
 bool EditorApp::CloseAllWindows()
 {
     for (auto& [ptr, wnd] : m_editors)
@@ -485,6 +541,10 @@ bool EditorApp::SaveSession(std::optional<const std::filesystem::path> path)
     dlgConfig.fileMaskList  = FileDialog::s_vars.maskList;
     dlgConfig.findList      = FindDialog::s_vars.findList;
     dlgConfig.replaceList   = FindDialog::s_vars.replaceList;
+    dlgConfig.useIndex      = FindFileDialog::s_vars.useIndex;
+    dlgConfig.scanBinary    = FindFileDialog::s_vars.binary;
+    for (auto& index : m_fileIndexes)
+        dlgConfig.indexList.push_back(index->GetRoot().u8string());
     sesConfig.SaveConfig(dlgConfig);
 
     if (path)
@@ -564,6 +624,14 @@ bool EditorApp::LoadSession(std::optional<const std::filesystem::path> path)
     FileDialog::s_vars.maskList     = dConfig.fileMaskList;
     FindDialog::s_vars.findList     = dConfig.findList;
     FindDialog::s_vars.replaceList  = dConfig.replaceList;
+    FindFileDialog::s_vars.useIndex = dConfig.useIndex;
+    FindFileDialog::s_vars.binary   = dConfig.scanBinary;
+
+    //indexes are updated in background
+    m_fileIndexes.clear();
+    for (auto& root : dConfig.indexList)
+        if (std::filesystem::is_directory(utf8::utf8to16(root)))
+            GetFileIndex(utf8::utf8to16(root), true);
     
     m_recentFiles.clear();
     for (auto& file : fileConfig)
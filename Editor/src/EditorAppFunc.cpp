@@ -194,19 +194,16 @@ bool    EditorApp::FindInFilesProc([[maybe_unused]] input_t cmd)
     if (ret == ID_OK)
     {
         FileSaveAllProc(0);
-        SearchFileDialog sdlg;
+        auto foundWnd = GetFoundWnd();
+        if (!foundWnd)
+            return false;
+
+        SearchFileDialog sdlg(foundWnd);
         ret = sdlg.Activate();
 
-        MatchedFileDialog mdlg;
-        ret = mdlg.Activate();
-        if (ret == ID_OK)
-        {
-            std::filesystem::path path = mdlg.s_path;
-            auto [t, parser] = LexParser::GetFileType(path);
-            auto rc = OpenFile(path, parser, FileDialog::s_vars.cpName);
-            if (rc)
-                PutCode(K_ED(E_CTRL_FINDDN));
-        }
+        if (SearchFileDialog::s_foundList.empty())
+            SetErrorLine("String not found");
+        WndManager::getInstance().SetTopWnd(foundWnd);
     }
 
     return true;
@@ -216,7 +213,24 @@ bool    EditorApp::ReplaceInFilesProc([[maybe_unused]] input_t cmd)
 {
     FindFileDialog dlg(true);
     auto ret = dlg.Activate();
-    if (ret == ID_OK)
+    if (ret == ID_OK && FindDialog::s_vars.noPrompt)
+    {
+        //files are changed on disk and then reloaded in opened windows
+        FileSaveAllProc(0);
+        auto foundWnd = GetFoundWnd(true);
+        if (!foundWnd)
+            return false;
+
+        SearchFileDialog sdlg(foundWnd, true);
+        ret = sdlg.Activate();
+
+        std::error_code ec;
+        for (auto& file : SearchFileDialog::s_foundList)
+            if (auto wnd = GetEditorWnd(std::filesystem::canonical(file, ec)))
+                reinterpret_cast<EditorWnd*>(wnd)->Reload(0);
+        WndManager::getInstance().SetTopWnd(foundWnd);
+    }
+    else if (ret == ID_OK)
     {
         FileSaveAllProc(0);
         SearchFileDialog sdlg;
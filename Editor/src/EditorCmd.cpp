@@ -218,6 +218,11 @@ CmdMap g_defaultEditKeyMap
     {{'N' | K_CTRL},            {K_ED(E_CTRL_FINDDN)}},
     {{'P' | K_ALT},             {K_ED(E_CTRL_FINDUPW)}},
     {{'N' | K_ALT},             {K_ED(E_CTRL_FINDDNW)}},
+    {{'B' | K_ALT},             {K_ED(E_CTRL_HIGHLIGHT)}},
+    {{K_ESC, 'b'},              {K_ED(E_CTRL_HIGHLIGHT)}},
+    {{K_ESC, 'B'},              {K_ED(E_CTRL_HIGHLIGHT)}},
+    {{K_F8 | K_SHIFT},          {K_ED(E_CTRL_HIGHLIGHTUP)}},
+    {{K_F8 | K_CTRL},           {K_ED(E_CTRL_HIGHLIGHTDN)}},
 
     {{'S' | K_CTRL},            {K_ED(E_CTRL_SAVE)}},
     {{K_ESC, K_F2},             {K_ED(E_CTRL_SAVE)}},
@@ -295,6 +300,9 @@ std::unordered_map<EditorCmd, std::pair<EditorWnd::EditorFunc, EditorWnd::select
     {E_CTRL_FINDDN,         {&EditorWnd::CtrlFindDown,           EditorWnd::select_state::begin}},
     {E_CTRL_FINDUPW,        {&EditorWnd::FindUpWord,             EditorWnd::select_state::begin}},
     {E_CTRL_FINDDNW,        {&EditorWnd::FindDownWord,           EditorWnd::select_state::begin}},
+    {E_CTRL_HIGHLIGHT,      {&EditorWnd::Highlight,              EditorWnd::select_state::no}},
+    {E_CTRL_HIGHLIGHTUP,    {&EditorWnd::HighlightUp,            EditorWnd::select_state::begin}},
+    {E_CTRL_HIGHLIGHTDN,    {&EditorWnd::HighlightDown,          EditorWnd::select_state::begin}},
     {E_CTRL_REPLACE,        {&EditorWnd::Replace,                EditorWnd::select_state::end}},
     {E_CTRL_REPEAT,         {&EditorWnd::Repeat,                 EditorWnd::select_state::end}},
 
@@ -462,6 +470,9 @@ std::unordered_map<input_t, std::string> g_CmdNames
     { K_ED(E_CTRL_FINDDN),          "EDIT_CTRL_FINDDN"},
     { K_ED(E_CTRL_FINDUPW),         "EDIT_CTRL_FINDUPWORD"},
     { K_ED(E_CTRL_FINDDNW),         "EDIT_CTRL_FINDDNWORD"},
+    { K_ED(E_CTRL_HIGHLIGHT),       "EDIT_CTRL_HIGHLIGHT"},
+    { K_ED(E_CTRL_HIGHLIGHTUP),     "EDIT_CTRL_HIGHLIGHTUP"},
+    { K_ED(E_CTRL_HIGHLIGHTDN),     "EDIT_CTRL_HIGHLIGHTDN"},
     { K_ED(E_CTRL_REPLACE),         "EDIT_CTRL_REPLACE"},
     { K_ED(E_CTRL_REPEAT),          "EDIT_CTRL_REPEAT"},
     { K_ED(E_DLG_GOTO),             "EDIT_DLG_GOTO"},
@@ -148,6 +148,11 @@ static menu_list menuSearch
     {MENU_ITEM,         "Current Word U&p",             K_ED(E_CTRL_FINDUPW),       "Get word under the cursor and find up"},
     {MENU_ITEM,         "Current Word Dow&n",           K_ED(E_CTRL_FINDDNW),       "Get word under the cursor and find down"},
     {MENU_SEPARATOR},
+    {MENU_ITEM,         "&Highlight Word",              K_ED(E_CTRL_HIGHLIGHT),     "Add/remove word under the cursor to highlighted"},
+    {MENU_ITEM,         "Highligh&ted Up",              K_ED(E_CTRL_HIGHLIGHTUP),   "Find any highlighted word up"},
+    {MENU_ITEM,         "Highlighted Do&wn",            K_ED(E_CTRL_HIGHLIGHTDN),   "Find any highlighted word down"},
+    {MENU_ITEM,         "&Clear Highlighting",          K_ED(E_CTRL_HIGHLIGHT) | 1, "Remove all highlighted words"},
+    {MENU_SEPARATOR},
     {MENU_ITEM,         "&Goto Line...",                K_ED(E_DLG_GOTO),           "Go to line number"},
     {MENU_SEPARATOR},
     {MENU_ITEM,         "F&ind in Files...",            K_APP_FINDFILE,             "Find in all files"},
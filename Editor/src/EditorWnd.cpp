@@ -429,7 +429,8 @@ bool EditorWnd::PrintStr(pos_t x, pos_t y, const std::u16string& wstr, size_t of
     {
         std::vector<color_t> colorBuff;
         rc = m_editor->GetColor(m_firstLine + y, wstr, colorBuff, offset + len);
-        [[maybe_unused]]bool rc1 = MarkAllFound(wstr, colorBuff);
+        [[maybe_unused]]bool rc1 = MarkHighlight(wstr, colorBuff);
+        [[maybe_unused]]bool rc2 = MarkAllFound(line, wstr, colorBuff);
 
         if (rc)
             rc = WriteColorStr(x, y, str, std::vector<color_t>(colorBuff.cbegin() + offset, colorBuff.cend()));
@@ -638,7 +639,10 @@ input_t EditorWnd::EventProc(input_t code)
     {
         //check for file changing by external program
         if (WndManager::getInstance().IsVisible(this))
+        {
             CheckFileChanging();
+            UpdateMatchIndex();
+        }
     }
 
     if ( code != K_TIME
@@ -764,6 +768,14 @@ input_t EditorWnd::ParseCommand(input_t cmd)
             break;
         }
     }
+    else if (cmd == K_PASTE)
+    {
+        if (m_selectMouse)
+            return 0;
+
+        SelectEnd(cmd);
+        EditPasteTerminal(cmd);
+    }
     else if(0 != (cmd &  EDITOR_CMD))
     {
         EditorCmd ecmd = static_cast<EditorCmd>((cmd - EDITOR_CMD) >> 16);
@@ -1584,6 +1596,9 @@ bool EditorWnd::FindUp(bool silence)
         return false;
     }
 
+    if (FindDialog::s_vars.regex)
+        return FindRegexUp(silence);
+
     if (!silence)
         EditorApp::SetHelpLine("Search. Press any key for cancel");
 
@@ -1598,6 +1613,8 @@ bool EditorWnd::FindUp(bool silence)
         );
     }
 
+    StartMatchIndex();
+
     //find only latin symbols
     bool fast{ true };
     for (auto c : m_findStr)
@@ -1639,12 +1656,26 @@ bool EditorWnd::FindUp(bool silence)
     }
 
     m_editor->FlushCurStr();
+    if (auto index = GetMatchIndex())
+        return FindInIndex(*index, true, line, offset, end, silence);
 
     size_t begin{ line };
     size_t progress{};
     bool userBreak{};
+    auto finder = m_editor->GetStrFinder(FindDialog::s_vars.findStrW, FindDialog::s_vars.checkCase);
     while (line >= end)
     {
+        if (finder && offset == 0)
+        {
+            //skip lines without string
+            auto found = m_editor->FindStrLine(*finder, line, end, true, [this, &userBreak, begin](size_t l) {
+                return userBreak = UpdateProgress((begin - l) * 99 / begin) || CheckInput(0ms);
+            });
+            if (!found)
+                break;
+            line = *found;
+        }
+
         auto str = m_editor->GetStrForFind(line, FindDialog::s_vars.checkCase, fast && offset == 0);
         if (0 != offset && offset > str.size())
         {
@@ -1668,20 +1699,7 @@ bool EditorWnd::FindUp(bool silence)
                 if (!FindDialog::s_vars.findWord || IsWord(str, offset, size))
                 {
                     LOG_IF(time(NULL) - t, DEBUG) << "    Found time=" << time(NULL) - t;
-                    _GotoXY(offset, line);
-
-                    m_foundX = offset;
-                    m_foundY = line;
-                    if (offset - m_xOffset + size < static_cast<size_t>(m_clientSizeX))
-                        m_foundSize = size;
-                    else
-                        m_foundSize = m_clientSizeX - (offset - m_xOffset);
-
-                    Invalidate(m_foundY, invalidate_t::find, m_foundX, m_foundSize);
-
-                    if (!silence)
-                        EditorApp::SetHelpLine();
-                    return true;
+                    return ShowFound(offset, line, size, silence);
                 }
                 else
                     itBegin = itFound + 1;
@@ -1726,6 +1744,9 @@ bool EditorWnd::FindDown(bool silence)
         return false;
     }
 
+    if (FindDialog::s_vars.regex)
+        return FindRegexDown(silence);
+
     if (!silence)
         EditorApp::SetHelpLine("Search. Press any key for cancel");
 
@@ -1740,6 +1761,8 @@ bool EditorWnd::FindDown(bool silence)
         );
     }
     
+    StartMatchIndex();
+
     //find only latin symbols
     bool fast{true};
     for(auto c : m_findStr)
@@ -1775,12 +1798,26 @@ bool EditorWnd::FindDown(bool silence)
         ++offset;
 
     m_editor->FlushCurStr();
+    if (auto index = GetMatchIndex())
+        return FindInIndex(*index, false, line, offset, end, silence);
 
     size_t begin{ line };
     size_t progress{};
     bool userBreak{};
+    auto finder = m_editor->GetStrFinder(FindDialog::s_vars.findStrW, FindDialog::s_vars.checkCase);
     while (line < end)
     {
+        if (finder && offset == 0)
+        {
+            //skip lines without string
+            auto found = m_editor->FindStrLine(*finder, line, end, false, [this, &userBreak, begin, end](size_t l) {
+                return userBreak = UpdateProgress((l - begin) * 99 / (end - begin)) || CheckInput(0ms);
+            });
+            if (!found)
+                break;
+            line = *found;
+        }
+
         auto str = m_editor->GetStrForFind(line, FindDialog::s_vars.checkCase, fast && offset == 0);
         if (0 != offset && offset > str.size())
         {
@@ -1806,20 +1843,7 @@ bool EditorWnd::FindDown(bool silence)
                 if (!FindDialog::s_vars.findWord || IsWord(str, offset, size))
                 {
                     LOG_IF(time(NULL) - t, DEBUG) << "    Found time=" << time(NULL) - t;
-                    _GotoXY(offset, line);
-
-                    m_foundX = offset;
-                    m_foundY = line;
-                    if (offset - m_xOffset + size < static_cast<size_t>(m_clientSizeX))
-                        m_foundSize = size;
-                    else
-                        m_foundSize = m_clientSizeX - (offset - m_xOffset);
-
-                    Invalidate(m_foundY, invalidate_t::find, m_foundX, m_foundSize);
-
-                    if (!silence)
-                        EditorApp::SetHelpLine();
-                    return true;
+                    return ShowFound(offset, line, size, silence);
                 }
                 else
                     itBegin = itFound + 1;
@@ -1853,178 +1877,1122 @@ bool EditorWnd::FindDown(bool silence)
     return false;
 }
 
-bool EditorWnd::MarkAllFound(const std::u16string& wstr, std::vector<color_t>& colorBuff)
+//regex works with UTF-8 string, offset[column] is position in it
+static std::string GetRegexStr(const std::u16string& wstr, std::vector<size_t>& offset)
 {
-    if (!m_markAllFound)
-        return true;
-    if (m_findStr.empty())
-        return true;
-
-    auto size = m_findStr.size();
-    std::u16string str{wstr};
-    if (!FindDialog::s_vars.checkCase)
+    std::string str;
+    offset.resize(wstr.size() + 1);
+    for (size_t i = 0; i < wstr.size(); ++i)
     {
-        std::transform(str.begin(), str.end(), str.begin(),
-            [](char16_t c) { return std::towupper(c); }
-        );
+        offset[i] = str.size();
+        utf8::unchecked::append(static_cast<uint32_t>(wstr[i]), std::back_inserter(str));
     }
+    offset[wstr.size()] = str.size();
 
-    searcher_t searcher(m_findStr.cbegin(), m_findStr.cend());
+    return str;
+}
+
+static size_t GetRegexColumn(const std::vector<size_t>& offset, size_t pos)
+{
+    return std::distance(offset.cbegin(), std::lower_bound(offset.cbegin(), offset.cend(), pos));
+}
+
+//all found substrings in the same order as search down finds them
+static void FindAllStr(const std::u16string& str, const std::u16string& findStr, bool word, line_match_t& found)
+{
+    searcher_t searcher(findStr.cbegin(), findStr.cend());
+    auto size = findStr.size();
     auto itBegin = str.cbegin();
     while (itBegin != str.cend())
     {
         auto itFound = std::search(itBegin, str.cend(), searcher);
-        if (itFound != str.cend())
-        {
-            auto offset = std::distance(str.cbegin(), itFound);
-            if (!FindDialog::s_vars.findWord || IsWord(str, offset, size))
-            {
-                //mark found
-                for (size_t i = 0; i < size && offset + i < colorBuff.size(); ++i)
-                    colorBuff[offset + i] = ColorWindowSelect;
-            }
+        if (itFound == str.cend())
+            break;
 
+        auto offset = static_cast<size_t>(std::distance(str.cbegin(), itFound));
+        if (!word || EditorWnd::IsWord(str, offset, size))
+        {
+            found.emplace_back(offset, size);
             itBegin = itFound + size;
         }
         else
+            itBegin = itFound + 1;
+    }
+}
+
+static void FindAllRegex(Regex& regex, const std::u16string& wstr, bool word, line_match_t& found)
+{
+    std::vector<size_t> offset;
+    auto str = GetRegexStr(wstr, offset);
+
+    match_t match;
+    size_t pos{};
+    while (regex.Match(str, pos, match))
+    {
+        auto [b, e] = match[0];
+        auto bx = GetRegexColumn(offset, b);
+        auto ex = GetRegexColumn(offset, e);
+        if (e > b && (!word || EditorWnd::IsWord(wstr, bx, ex - bx)))
+        {
+            found.emplace_back(bx, ex - bx);
+            pos = e;
+            continue;
+        }
+
+        if (bx >= wstr.size())
             break;
+        pos = offset[bx + 1];
+    }
+}
+
+bool EditorWnd::PrepareRegex()
+{
+    auto pattern = utf8::utf16to8(FindDialog::s_vars.findStrW);
+    bool checkCase = FindDialog::s_vars.checkCase;
+    auto cp = m_editor->GetCP();
+
+    std::string key{ pattern + '\n' + (checkCase ? '1' : '0') + cp };
+    if (m_regex && key == m_regexKey)
+        return true;
+
+    m_regexKey.clear();
+    m_rawRegex.reset();
+    m_regex = std::make_unique<Regex>(pattern, checkCase);
+    if (!m_regex->IsValid())
+    {
+        EditorApp::SetErrorLine("Regular expression: " + m_regex->GetError());
+        m_regex.reset();
+        return false;
     }
 
+    //filter for strings in file code page,
+    //single byte code pages are checked only with latin pattern
+    bool latin = pattern.find("\\x") == std::string::npos
+        && std::all_of(pattern.cbegin(), pattern.cend(), [](char c) { return static_cast<unsigned char>(c) < 0x80; });
+    if (cp == "UTF-8")
+        m_rawRegex = std::make_unique<Regex>(pattern, checkCase);
+    else if (latin)
+        m_rawRegex = std::make_unique<Regex>(pattern, checkCase, false);
+
+    m_regexKey = key;
     return true;
 }
 
-bool EditorWnd::EditWndCopy(EditorWnd* from)
+bool EditorWnd::MatchRegex(const std::u16string& wstr, size_t from, size_t to, bool last, size_t& x, size_t& size)
 {
-    if (m_readOnly)
-        return true;
+    std::vector<size_t> offset;
+    auto str = GetRegexStr(wstr, offset);
 
-    LOG(DEBUG) << "    EditWndCopy";
+    bool found{};
+    match_t match;
+    size_t pos{ offset[std::min(from, wstr.size())] };
+    while (m_regex->Match(str, pos, match))
+    {
+        auto [b, e] = match[0];
+        size_t bx = GetRegexColumn(offset, b);
+        if (bx >= to)
+            break;
 
-    std::vector<std::u16string> buff;
-    select_t type;
+        //skip empty matches
+        if (e > b)
+        {
+            size_t len = GetRegexColumn(offset, e) - bx;
+            if (!FindDialog::s_vars.findWord || IsWord(wstr, bx, len))
+            {
+                x = bx;
+                size = len;
+                found = true;
+                if (!last)
+                    break;
+            }
+        }
 
-    bool rc = from->CopySelected(buff, type)
-    && PasteSelected(buff, type);
+        if (bx >= wstr.size())
+            break;
+        pos = offset[bx + 1];
+    }
 
-    return rc;
+    return found;
 }
 
-bool EditorWnd::EditWndMove(EditorWnd* from)
+bool EditorWnd::ShowFound(size_t x, size_t y, size_t size, bool silence)
 {
-    if (m_readOnly)
-        return true;
+    _GotoXY(x, y);
 
-    LOG(DEBUG) << "    EditWndMove";
-
-    std::vector<std::u16string> buff;
-    select_t type;
+    m_foundX = x;
+    m_foundY = y;
+    if (x - m_xOffset + size < static_cast<size_t>(m_clientSizeX))
+        m_foundSize = size;
+    else
+        m_foundSize = m_clientSizeX - (x - m_xOffset);
 
-    bool rc = from->CopySelected(buff, type)
-        && PasteSelected(buff, type)
-        && from->DelSelected();
+    Invalidate(m_foundY, invalidate_t::find, m_foundX, m_foundSize);
 
-    return rc;
+    if (!silence)
+        ShowMatchNumber();
+    return true;
 }
 
-Wnd* EditorWnd::CloneWnd()
+bool EditorWnd::FindRegexUp(bool silence)
 {
-    //LOG(DEBUG) << "CloneWnd";
+    if (!PrepareRegex())
+        return false;
 
-    m_clonedWnd = std::make_shared<EditorWnd>();
-    EditorWnd* wnd = m_clonedWnd.get();
-    if (!wnd)
+    if (!silence)
+        EditorApp::SetHelpLine("Search. Press any key for cancel");
+
+    m_findStr = FindDialog::s_vars.findStrW;
+    StartMatchIndex();
+
+    //search diaps
+    size_t line{ m_firstLine + m_cursory };
+    size_t end{};
+    if (FindDialog::s_vars.inSelected && m_selectState == select_state::complete)
     {
-        _assert(0);
-        return nullptr;
+        if (m_beginY <= m_endY)
+        {
+            if (line > m_endY)
+                line = m_endY;
+            end = m_beginY;
+        }
+        else
+        {
+            if (line > m_beginY)
+                line = m_beginY;
+            end = m_endY;
+        }
     }
 
-    wnd->SetEditor(m_editor);
-    wnd->m_deleted = m_deleted;
-    wnd->m_saved = m_saved;
-    wnd->m_untitled = m_untitled;
-    wnd->m_readOnly = m_readOnly;
-    wnd->m_log = m_log;
-    wnd->m_checkTime = m_checkTime;
-
-    wnd->m_clone = true;
-    wnd->m_visible = true;
-    wnd->_GotoXY(m_xOffset + m_cursorx, m_firstLine + m_cursory);
+    size_t offset{ m_xOffset + m_cursorx };
+    if (offset == 0)
+    {
+        if (line)
+            --line;
+        else
+        {
+            EditorApp::SetErrorLine("Nothing to find");
+            return false;
+        }
+    }
 
-    return wnd;
-}
+    m_editor->FlushCurStr();
+    if (auto index = GetMatchIndex())
+        return FindInIndex(*index, true, line, offset, end, silence);
 
-bool EditorWnd::Destroy() 
-{ 
-    if (m_clone)
+    size_t begin{ line };
+    size_t progress{};
+    bool userBreak{};
+    while (line >= end)
     {
-        auto list = m_editor->GetLinkedWnd(this);
-        m_editor->UnlinkWnd(this);
-        for (auto wnd : list)
+        //check file string before conversion
+        if (!m_rawRegex || m_editor->CheckRegex(line, *m_rawRegex))
         {
-            if (!wnd->IsClone())
-            {
-                auto editorWnd = reinterpret_cast<EditorWnd*>(wnd);
-                editorWnd->m_clonedWnd = nullptr;
+            auto str = m_editor->GetStrForFind(line, true, false);
+            size_t x, size;
+            if (MatchRegex(str, 0, offset ? offset : Regex::npos, true, x, size))
+                return ShowFound(x, line, size, silence);
+        }
+        offset = 0;
+
+        if (line)
+            --line;
+        else
+            break;
+
+        if (++progress == 1000)
+        {
+            progress = 0;
+            if (userBreak = UpdateProgress((begin - line) * 99 / begin); userBreak)
                 break;
-            }
         }
     }
-    return true; 
-}
 
-bool EditorWnd::GetSelectedLines(size_t& begin, size_t& end)
-{
-    if (!IsMarked())
-        return false;
-    if (m_beginY >= m_endY)
-    {
-        begin = m_beginY;
-        end = m_endY;
-    }
-    else
+    if (!silence)
     {
-        begin = m_endY;
-        end = m_beginY;
+        HideFound();
+        if (!userBreak)
+            EditorApp::SetErrorLine("String not found");
+        else
+            EditorApp::SetHelpLine("User abort", stat_color::grayed);
     }
 
-    return true;
+    return false;
 }
 
-bool EditorWnd::ReplaceSubstr(size_t line, size_t pos, size_t len, const std::u16string& substr)
+bool EditorWnd::FindRegexDown(bool silence)
 {
-    if (m_readOnly)
-        return true;
+    if (!PrepareRegex())
+        return false;
 
-    size_t newSize = substr.size();
-    bool rc = m_editor->ReplaceSubstr(true, line, pos, len, substr);
-    if (len > newSize)
-        ChangeSelected(select_change::delete_ch, line, pos, len - newSize);
-    else if (newSize > len)
-        ChangeSelected(select_change::insert_ch, line, pos, newSize - len);
+    if (!silence)
+        EditorApp::SetHelpLine("Search. Press any key for cancel");
 
-    return rc;
-}
+    m_findStr = FindDialog::s_vars.findStrW;
+    StartMatchIndex();
 
-bool EditorWnd::TryDeleteSelectedBlock()
-{
-    if (m_selectState != select_state::complete)
+    //search diaps
+    size_t line{ m_firstLine + m_cursory };
+    size_t end{ m_editor->GetStrCount() };
+    if (FindDialog::s_vars.inSelected && m_selectState == select_state::complete)
     {
-        return false;
+        if (m_beginY <= m_endY)
+        {
+            if (line < m_beginY)
+                line = m_beginY;
+            end = m_endY;
+        }
+        else
+        {
+            if (line < m_endY)
+                line = m_endY;
+            end = m_beginY;
+        }
     }
 
-    CorrectSelection();
-    size_t x = m_xOffset + m_cursorx;
-    size_t y = m_firstLine + m_cursory;
-    if ((y < m_beginY || y > m_endY)
-        || (m_selectType == select_t::stream && ((y == m_beginY && x < m_beginX) || (y == m_endY && x > m_endX)))
-        || (m_selectType == select_t::column && (x < m_beginX || x > m_endX)))
-    {
-        //cursor out of selected block
-        SelectUnselect(0);
-        return false;
-    }
+    size_t offset{ m_xOffset + m_cursorx };
+    if (m_foundSize && m_foundY == line && m_foundX == offset)
+        offset += m_foundSize;
+    else
+        ++offset;
 
-    return EditBlockDel(0);
+    m_editor->FlushCurStr();
+    if (auto index = GetMatchIndex())
+        return FindInIndex(*index, false, line, offset, end, silence);
+
+    size_t begin{ line };
+    size_t progress{};
+    bool userBreak{};
+    while (line < end)
+    {
+        //check file string before conversion
+        if (!m_rawRegex || m_editor->CheckRegex(line, *m_rawRegex))
+        {
+            auto str = m_editor->GetStrForFind(line, true, false);
+            size_t x, size;
+            if (offset <= str.size() && MatchRegex(str, offset, Regex::npos, false, x, size))
+                return ShowFound(x, line, size, silence);
+        }
+        offset = 0;
+        ++line;
+
+        if (++progress == 1000)
+        {
+            progress = 0;
+            if (userBreak = UpdateProgress((line - begin) * 99 / (end - begin)); userBreak)
+                break;
+        }
+    }
+
+    if (!silence)
+    {
+        HideFound();
+        if (!userBreak)
+            EditorApp::SetErrorLine("String not found");
+        else
+            EditorApp::SetHelpLine("User abort", stat_color::grayed);
+    }
+
+    return false;
+}
+
+bool EditorWnd::GetRegexReplace(size_t& len, std::u16string& replace)
+{
+    if (!m_regex)
+        return false;
+
+    auto wstr = m_editor->GetStrForFind(m_foundY, true, false);
+    if (m_foundX >= wstr.size())
+        return false;
+
+    std::vector<size_t> offset;
+    auto str = GetRegexStr(wstr, offset);
+
+    match_t match;
+    if (!m_regex->Match(str, offset[m_foundX], match) || match[0].first != offset[m_foundX])
+        return false;
+
+    len = GetRegexColumn(offset, match[0].second) - m_foundX;
+    replace = utf8::utf8to16(Regex::Expand(str, match, utf8::utf16to8(replace)));
+    return true;
+}
+
+bool EditorWnd::ReplaceAll(size_t& count, bool& userBreak)
+{
+    bool regex{ FindDialog::s_vars.regex };
+    if ((regex && !m_regex) || m_matchKey.empty() || !m_editor->GetMatchIndex(m_matchKey, false))
+        return false;
+
+    size_t begin{ m_foundY };
+    size_t end{ m_editor->GetStrCount() };
+    if (FindDialog::s_vars.inSelected && m_selectState == select_state::complete)
+        end = std::max(m_beginY, m_endY);
+
+    //all file is scanned before replacing
+    const MatchIndex* index;
+    while (!(index = GetMatchIndex()))
+    {
+        m_editor->UpdateMatchIndex([this, &userBreak]() {
+            size_t line = m_editor->GetMatchIndex(m_matchKey, false)->GetScanLine();
+            return userBreak = UpdateProgress(line * 49 / m_editor->GetStrCount()) || CheckInput(0ms);
+        });
+        if (userBreak)
+            return false;
+    }
+
+    //index will be changed with replacing
+    auto matches = index->GetMatches(m_foundY, m_foundX, end);
+    auto& replaceStr = FindDialog::s_vars.replaceStrW;
+    auto replaceStr8 = utf8::utf16to8(replaceStr);
+
+    size_t progress{};
+    auto it = matches.cbegin();
+    while (it != matches.cend())
+    {
+        size_t line{ it->line };
+        auto lineEnd = std::find_if(it, matches.cend(), [line](const MatchIndex::Match& match) { return match.line != line; });
+
+        //all matches in line are replaced with one command
+        line_replace_t replace;
+        if (!regex)
+        {
+            for (; it != lineEnd; ++it)
+                replace.emplace_back(it->x, it->size, replaceStr);
+        }
+        else
+        {
+            auto wstr = m_editor->GetStrForFind(line, true, false);
+            std::vector<size_t> offset;
+            auto str = GetRegexStr(wstr, offset);
+
+            size_t prevEnd{};
+            for (; it != lineEnd; ++it)
+            {
+                match_t match;
+                if (it->x < prevEnd || it->x >= wstr.size()
+                    || !m_regex->Match(str, offset[it->x], match) || match[0].first != offset[it->x])
+                    continue;
+
+                prevEnd = GetRegexColumn(offset, match[0].second);
+                replace.emplace_back(it->x, prevEnd - it->x, utf8::utf8to16(Regex::Expand(str, match, replaceStr8)));
+            }
+        }
+
+        if (replace.empty())
+            continue;
+        if (!m_editor->ReplaceLine(true, line, replace))
+            return false;
+
+        //from line end for saving positions
+        for (auto r = replace.crbegin(); r != replace.crend(); ++r)
+        {
+            auto& [x, len, str] = *r;
+            if (len > str.size())
+                ChangeSelected(select_change::delete_ch, line, x, len - str.size());
+            else if (str.size() > len)
+                ChangeSelected(select_change::insert_ch, line, x, str.size() - len);
+        }
+
+        //last replaced substring
+        size_t x{};
+        for (auto& [pos, len, str] : replace)
+        {
+            m_foundX = x + pos;
+            m_foundSize = str.size();
+            x += str.size() - len;
+        }
+        m_foundY = line;
+        count += replace.size();
+
+        if (++progress == 1000)
+        {
+            progress = 0;
+            userBreak = UpdateProgress(49 + (line - begin) * 50 / (end - begin));
+            if (userBreak)
+                break;
+        }
+    }
+
+    if (count)
+        _GotoXY(m_foundX + m_foundSize, m_foundY);
+
+    return true;
+}
+
+bool EditorWnd::StartMatchIndex()
+{
+    auto& vars = FindDialog::s_vars;
+    m_matchKey = utf8::utf16to8(vars.findStrW) + '\n'
+        + (vars.checkCase ? '1' : '0') + (vars.findWord ? '1' : '0') + (vars.regex ? '1' : '0');
+    if (m_editor->GetMatchIndex(m_matchKey, false))
+        return true;
+
+    //index is scanned in editor, so matching doesn't depend on this window
+    Editor* editor = m_editor.get();
+    bool word = vars.findWord;
+    if (vars.regex)
+    {
+        if (!m_regex)
+        {
+            m_matchKey.clear();
+            return false;
+        }
+
+        auto regex = std::make_shared<Regex>(*m_regex);
+        auto rawRegex = m_rawRegex ? std::make_shared<Regex>(*m_rawRegex) : nullptr;
+        return m_editor->SetMatchIndex(m_matchKey, [editor, regex, rawRegex, word](size_t line, line_match_t& found) {
+            if (!rawRegex || editor->CheckRegex(line, *rawRegex))
+                FindAllRegex(*regex, editor->GetStrForFind(line, true, false), word, found);
+        });
+    }
+
+    bool checkCase = vars.checkCase;
+    return m_editor->SetMatchIndex(m_matchKey, [editor, findStr = m_findStr, checkCase, word](size_t line, line_match_t& found) {
+        FindAllStr(editor->GetStrForFind(line, checkCase, false), findStr, word, found);
+    }, m_editor->GetStrFinder(vars.findStrW, checkCase));
+}
+
+bool EditorWnd::UpdateMatchIndex()
+{
+    if (m_matchKey.empty() || !m_editor->GetMatchIndex(m_matchKey, false))
+        return false;
+
+    //work until user presses any key
+    if (!m_editor->UpdateMatchIndex([]() { return WndManager::getInstance().InputPending(); }))
+        return false;
+
+    if (m_markAllFound)
+    {
+        InvalidateRect(0, 0, m_clientSizeX, m_clientSizeY);
+        Repaint();
+    }
+    if (m_foundSize)
+        ShowMatchNumber();
+
+    return true;
+}
+
+const MatchIndex* EditorWnd::GetMatchIndex()
+{
+    if (m_matchKey.empty())
+        return nullptr;
+
+    auto index = m_editor->GetMatchIndex(m_matchKey);
+    if (!index || !index->IsComplete(m_editor->GetStrCount()))
+        return nullptr;
+    return index;
+}
+
+bool EditorWnd::FindInIndex(const MatchIndex& index, bool up, size_t line, size_t offset, size_t end, bool silence)
+{
+    std::optional<MatchIndex::Match> match;
+    if (up)
+        match = index.FindUp(line, offset ? offset : STR_NOTDEFINED, end, !FindDialog::s_vars.regex);
+    else
+        match = index.FindDown(line, offset, end);
+
+    if (match)
+        return ShowFound(match->x, match->line, match->size, silence);
+
+    if (!silence)
+    {
+        HideFound();
+        EditorApp::SetErrorLine("String not found");
+    }
+    return false;
+}
+
+bool EditorWnd::ShowMatchNumber()
+{
+    std::optional<size_t> n;
+    auto index = GetMatchIndex();
+    if (index)
+        n = index->GetNumber(m_foundY, m_foundX);
+
+    if (!n)
+        return EditorApp::SetHelpLine();
+    return EditorApp::SetHelpLine("Match " + std::to_string(*n + 1) + " of " + std::to_string(index->GetCount()));
+}
+
+bool EditorWnd::IncFindStart()
+{
+    auto& inc = m_incFind;
+    inc = {};
+    inc.active = true;
+    inc.beginX = m_xOffset + m_cursorx;
+    inc.beginY = m_firstLine + m_cursory;
+    inc.firstLine = m_firstLine;
+    inc.xOffset = m_xOffset;
+    inc.findStr = m_findStr;
+    inc.matchKey = m_matchKey;
+    inc.markAllFound = m_markAllFound;
+    return true;
+}
+
+bool EditorWnd::IncFind(const std::u16string& str)
+{
+    auto& inc = m_incFind;
+    if (!inc.active)
+        return false;
+
+    auto& vars = FindDialog::s_vars;
+    bool same = vars.checkCase == inc.checkCase && vars.findWord == inc.findWord;
+    if (same && str == inc.str)
+        return inc.found;
+
+    //longer string can be found only from found position of its beginning,
+    //but not whole word
+    bool extend = same && !vars.findWord && !inc.str.empty()
+        && str.size() > inc.str.size() && str.compare(0, inc.str.size(), inc.str) == 0;
+    if (!extend)
+    {
+        inc.x = inc.beginX;
+        inc.y = inc.beginY;
+        inc.notFound = false;
+    }
+    inc.found = false;
+    inc.str = str;
+    inc.checkCase = vars.checkCase;
+    inc.findWord = vars.findWord;
+
+    vars.findStrW = str;
+    m_findStr = str;
+    if (!inc.checkCase)
+    {
+        std::transform(m_findStr.begin(), m_findStr.end(), m_findStr.begin(),
+            [](char16_t c) { return std::towupper(c); }
+        );
+    }
+
+    if (str.empty())
+    {
+        m_markAllFound = inc.markAllFound;
+        return IncFindRestore();
+    }
+
+    //all visible strings are marked, index is made after closing dialog,
+    //previous index is kept for cancel
+    m_markAllFound = true;
+    m_matchKey.clear();
+    if (inc.notFound)
+    {
+        IncFindRestore();
+        return EditorApp::SetErrorLine("String not found");
+    }
+
+    return IncFindNext();
+}
+
+bool EditorWnd::IncFindNext()
+{
+    auto& inc = m_incFind;
+    if (!inc.active || inc.str.empty() || inc.found || inc.notFound)
+        return false;
+
+    m_editor->FlushCurStr();
+
+    size_t size{ inc.str.size() };
+    size_t end{ m_editor->GetStrCount() };
+    size_t line{ inc.y };
+    size_t offset{ inc.x };
+    bool stop{};
+
+    auto finder = m_editor->GetStrFinder(inc.str, inc.checkCase);
+    searcher_t searcher(m_findStr.cbegin(), m_findStr.cend());
+    for (size_t progress{}; line < end; ++line, offset = 0)
+    {
+        //search is stopped with any key and continued from the same place
+        if (finder && offset == 0)
+        {
+            auto found = m_editor->FindStrLine(*finder, line, end, false, [&line, &stop](size_t l) {
+                line = l;
+                return stop = WndManager::getInstance().InputPending();
+            });
+            if (!found)
+            {
+                if (!stop)
+                    line = end;
+                break;
+            }
+            line = *found;
+        }
+        else if (++progress == 1000)
+        {
+            progress = 0;
+            if (stop = WndManager::getInstance().InputPending(); stop)
+                break;
+        }
+
+        auto str = m_editor->GetStrForFind(line, inc.checkCase, false);
+        auto itBegin = str.cbegin() + std::min(offset, str.size());
+        while (itBegin != str.cend())
+        {
+            auto itFound = std::search(itBegin, str.cend(), searcher);
+            if (itFound == str.cend())
+                break;
+
+            size_t x = std::distance(str.cbegin(), itFound);
+            if (!inc.findWord || IsWord(str, x, size))
+            {
+                inc.x = x;
+                inc.y = line;
+                inc.found = true;
+
+                //dialog is in the middle of screen, so found string is shown on the top
+                m_foundSize = 0;
+                if (line < m_firstLine || line >= m_firstLine + m_clientSizeY / 4)
+                    _GotoXY(x, line ? line - 1 : 0, true);
+                ShowFound(x, line, size, true);
+                EditorApp::SetHelpLine();
+                WndManager::getInstance().Invalidate();
+                return true;
+            }
+            itBegin = itFound + 1;
+        }
+    }
+
+    inc.x = offset;
+    inc.y = line;
+    if (stop)
+        return false;
+
+    inc.notFound = true;
+    IncFindRestore();
+    EditorApp::SetErrorLine("String not found");
+    return false;
+}
+
+bool EditorWnd::IncFindEnd(bool ok)
+{
+    auto& inc = m_incFind;
+    if (!inc.active)
+        return false;
+
+    inc.active = false;
+    m_markAllFound = inc.markAllFound;
+
+    auto& vars = FindDialog::s_vars;
+    bool same = ok && !vars.regex && !vars.directionUp && !inc.str.empty() && vars.findStrW == inc.str
+        && vars.checkCase == inc.checkCase && vars.findWord == inc.findWord;
+    if (same && inc.found)
+    {
+        //the last found string is the result of search
+        StartMatchIndex();
+        InvalidateRect();
+        return ShowFound(inc.x, inc.y, inc.str.size(), false);
+    }
+
+    if (!ok)
+    {
+        m_findStr = inc.findStr;
+        m_matchKey = inc.matchKey;
+    }
+    IncFindRestore();
+
+    if (same && inc.notFound)
+        return EditorApp::SetErrorLine("String not found");
+    return false;
+}
+
+bool EditorWnd::IncFindRestore()
+{
+    //all screen is refreshed
+    auto& inc = m_incFind;
+    m_foundSize = 0;
+    m_firstLine = inc.firstLine;
+    m_xOffset = inc.xOffset;
+    m_cursorx = static_cast<pos_t>(inc.beginX - m_xOffset);
+    m_cursory = static_cast<pos_t>(inc.beginY - m_firstLine);
+    InvalidateRect();
+    WndManager::getInstance().Invalidate();
+    return true;
+}
+
+bool EditorWnd::MarkAllFound(size_t line, const std::u16string& wstr, std::vector<color_t>& colorBuff)
+{
+    if (!m_markAllFound)
+        return true;
+    if (m_findStr.empty())
+        return true;
+
+    line_match_t found;
+    auto index = m_matchKey.empty() ? nullptr : m_editor->GetMatchIndex(m_matchKey, false);
+    if (index && index->IsScanned(line) && !m_editor->IsCurStrChanged(line))
+        found = index->GetLine(line);
+    else if (FindDialog::s_vars.regex)
+    {
+        if (!m_regex)
+            return true;
+        FindAllRegex(*m_regex, wstr, FindDialog::s_vars.findWord, found);
+    }
+    else if (!FindDialog::s_vars.checkCase)
+    {
+        std::u16string str{ wstr };
+        std::transform(str.begin(), str.end(), str.begin(),
+            [](char16_t c) { return std::towupper(c); }
+        );
+        FindAllStr(str, m_findStr, FindDialog::s_vars.findWord, found);
+    }
+    else
+        FindAllStr(wstr, m_findStr, FindDialog::s_vars.findWord, found);
+
+    //mark found
+    for (auto [x, size] : found)
+        for (size_t i = x; i < x + size && i < colorBuff.size(); ++i)
+            colorBuff[i] = ColorWindowSelect;
+
+    return true;
+}
+
+bool EditorWnd::GetHighlight(const std::u16string& wstr, std::vector<MultiStrFinder::Match>& found) const
+{
+    found.clear();
+    if (!m_highlightFinder)
+        return false;
+
+    //screen string in UTF-8 with spaces instead of tabs
+    std::string str;
+    std::vector<size_t> offset(wstr.size() + 1);
+    for (size_t i = 0; i < wstr.size(); ++i)
+    {
+        offset[i] = str.size();
+        auto c = wstr[i];
+        if (c < 0x80)
+            str += c > ' ' ? static_cast<char>(c) : ' ';
+        else
+            utf8::unchecked::append(static_cast<uint32_t>(c), std::back_inserter(str));
+    }
+    offset[wstr.size()] = str.size();
+
+    m_highlightFinder->FindAll(str, found);
+    for (auto& match : found)
+    {
+        auto x = GetRegexColumn(offset, match.pos);
+        match.size = GetRegexColumn(offset, match.pos + match.size) - x;
+        match.pos = x;
+    }
+
+    return !found.empty();
+}
+
+bool EditorWnd::MarkHighlight(const std::u16string& wstr, std::vector<color_t>& colorBuff)
+{
+    std::vector<MultiStrFinder::Match> found;
+    if (!GetHighlight(wstr, found))
+        return true;
+
+    for (auto& match : found)
+        for (size_t i = match.pos; i < match.pos + match.size && i < colorBuff.size(); ++i)
+            colorBuff[i] = ColorWindowHighlight(match.id);
+
+    return true;
+}
+
+bool EditorWnd::FindHighlight(bool up)
+{
+    if (!m_highlightFinder)
+    {
+        EditorApp::SetErrorLine("Nothing highlighted");
+        return false;
+    }
+
+    EditorApp::SetHelpLine("Search. Press any key for cancel");
+    m_editor->FlushCurStr();
+
+    //lines without highlighted strings are skipped in file data
+    std::vector<std::u16string> strs;
+    std::copy_if(m_highlight.cbegin(), m_highlight.cend(), std::back_inserter(strs),
+        [](const std::u16string& str) { return !str.empty(); });
+    auto finder = m_editor->GetMultiStrFinder(strs, m_highlightCase);
+
+    size_t line{ m_firstLine + m_cursory };
+    size_t x{ m_xOffset + m_cursorx };
+    size_t count{ m_editor->GetStrCount() };
+    size_t begin{ line };
+    bool userBreak{};
+    auto progress = [this, &userBreak, begin, count, up](size_t l) {
+        return userBreak = UpdateProgress(up ? (begin - l) * 99 / begin : (l - begin) * 99 / (count - begin))
+            || CheckInput(0ms);
+    };
+
+    std::vector<MultiStrFinder::Match> found;
+    auto check = [&](size_t l, bool current) -> bool {
+        GetHighlight(m_editor->GetStrForFind(l, true, false), found);
+        std::optional<MultiStrFinder::Match> match;
+        for (auto& m : found)
+            if (up && (!current || m.pos < x))
+                match = m;
+            else if (!up && (!current || m.pos > x))
+            {
+                match = m;
+                break;
+            }
+
+        if (!match)
+            return false;
+        EditorApp::SetHelpLine();
+        return ShowFound(match->pos, l, match->size, true);
+    };
+
+    if (line < count && check(line, true))
+        return true;
+
+    if (!up)
+    {
+        while (++line < count)
+        {
+            if (finder)
+            {
+                auto next = m_editor->FindStrLine(*finder, line, count, false, progress);
+                if (!next)
+                    break;
+                line = *next;
+            }
+            if (check(line, false))
+                return true;
+        }
+    }
+    else
+    {
+        while (line-- > 0)
+        {
+            if (finder)
+            {
+                auto next = m_editor->FindStrLine(*finder, line, 0, true, progress);
+                if (!next)
+                    break;
+                line = *next;
+            }
+            if (check(line, false))
+                return true;
+        }
+    }
+
+    HideFound();
+    if (!userBreak)
+        EditorApp::SetErrorLine("Highlighted string not found");
+    else
+        EditorApp::SetHelpLine("User abort", stat_color::grayed);
+    return false;
+}
+
+bool EditorWnd::EditWndCopy(EditorWnd* from)
+{
+    if (m_readOnly)
+        return true;
+
+    LOG(DEBUG) << "    EditWndCopy";
+
+    std::vector<std::u16string> buff;
+    select_t type;
+
+    bool rc = from->CopySelected(buff, type)
+    && PasteSelected(buff, type);
+
+    return rc;
+}
+
+bool EditorWnd::EditWndMove(EditorWnd* from)
+{
+    if (m_readOnly)
+        return true;
+
+    LOG(DEBUG) << "    EditWndMove";
+
+    std::vector<std::u16string> buff;
+    select_t type;
+
+    bool rc = from->CopySelected(buff, type)
+        && PasteSelected(buff, type)
+        && from->DelSelected();
+
+    return rc;
+}
+
+Wnd* EditorWnd::CloneWnd()
+{
+    //LOG(DEBUG) << "CloneWnd";
+
+    m_clonedWnd = std::make_shared<EditorWnd>();
+    EditorWnd* wnd = m_clonedWnd.get();
+    if (!wnd)
+    {
+        _assert(0);
+        return nullptr;
+    }
+
+    wnd->SetEditor(m_editor);
+    wnd->m_deleted = m_deleted;
+    wnd->m_saved = m_saved;
+    wnd->m_untitled = m_untitled;
+    wnd->m_readOnly = m_readOnly;
+    wnd->m_log = m_log;
+    wnd->m_checkTime = m_checkTime;
+    wnd->m_foundWnd = m_foundWnd;
+    wnd->m_foundInFiles = m_foundInFiles;
+
+    wnd->m_clone = true;
+    wnd->m_visible = true;
+    wnd->_GotoXY(m_xOffset + m_cursorx, m_firstLine + m_cursory);
+
+    return wnd;
+}
+
+bool EditorWnd::Destroy() 
+{ 
+    if (m_clone)
+    {
+        auto list = m_editor->GetLinkedWnd(this);
+        m_editor->UnlinkWnd(this);
+        for (auto wnd : list)
+        {
+            if (!wnd->IsClone())
+            {
+                auto editorWnd = reinterpret_cast<EditorWnd*>(wnd);
+                editorWnd->m_clonedWnd = nullptr;
+                break;
+            }
+        }
+    }
+    return true; 
+}
+
+bool EditorWnd::GetSelectedLines(size_t& begin, size_t& end)
+{
+    if (!IsMarked())
+        return false;
+    if (m_beginY >= m_endY)
+    {
+        begin = m_beginY;
+        end = m_endY;
+    }
+    else
+    {
+        begin = m_endY;
+        end = m_beginY;
+    }
+
+    return true;
+}
+
+bool EditorWnd::ReplaceSubstr(size_t line, size_t pos, size_t len, const std::u16string& substr)
+{
+    if (m_readOnly)
+        return true;
+
+    size_t newSize = substr.size();
+    bool rc = m_editor->ReplaceSubstr(true, line, pos, len, substr);
+    if (len > newSize)
+        ChangeSelected(select_change::delete_ch, line, pos, len - newSize);
+    else if (newSize > len)
+        ChangeSelected(select_change::insert_ch, line, pos, newSize - len);
+
+    return rc;
+}
+
+bool EditorWnd::TryDeleteSelectedBlock()
+{
+    if (m_selectState != select_state::complete)
+    {
+        return false;
+    }
+
+    CorrectSelection();
+    size_t x = m_xOffset + m_cursorx;
+    size_t y = m_firstLine + m_cursory;
+    if ((y < m_beginY || y > m_endY)
+        || (m_selectType == select_t::stream && ((y == m_beginY && x < m_beginX) || (y == m_endY && x > m_endX)))
+        || (m_selectType == select_t::column && (x < m_beginX || x > m_endX)))
+    {
+        //cursor out of selected block
+        SelectUnselect(0);
+        return false;
+    }
+
+    return EditBlockDel(0);
+}
+
+bool EditorWnd::StartFoundInFiles(const std::u16string& title)
+{
+    m_foundWnd = true;
+    m_readOnly = true;
+    m_foundInFiles.clear();
+
+    if (size_t count = m_editor->GetStrCount())
+        m_editor->DelLine(false, count - 1, count);
+    m_editor->AddLine(false, 0, title);
+    m_editor->ClearModifyFlag();
+
+    _GotoXY(0, 0);
+    return Refresh();
+}
+
+bool EditorWnd::AddFoundInFile(const std::filesystem::path& file, const std::vector<FileMatch>& matches)
+{
+    size_t line{ m_editor->GetStrCount() };
+    m_editor->AddLine(false, line++, utf8::utf8to16(file.u8string()));
+
+    for (auto& match : matches)
+    {
+        auto str = utf8::utf8to16("  " + std::to_string(match.line + 1) + ":" + std::to_string(match.pos + 1) + ": ");
+        if (match.offset)
+            str += u"...";
+        //tabs are shown as spaces
+        for (auto c : match.str)
+            str += c < ' ' ? ' ' : c;
+
+        m_editor->AddLine(false, line, str);
+        m_foundInFiles.emplace(line++, FoundInFile{ file, match });
+    }
+
+    m_editor->ClearModifyFlag();
+    return true;
+}
+
+bool EditorWnd::AddReplacedFile(const std::filesystem::path& file, size_t count)
+{
+    size_t line{ m_editor->GetStrCount() };
+    m_editor->AddLine(false, line, utf8::utf8to16(file.u8string() + " (" + std::to_string(count) + ")"));
+    m_foundInFiles.emplace(line, FoundInFile{ file, {} });
+
+    m_editor->ClearModifyFlag();
+    return true;
+}
+
+bool EditorWnd::AddReplaceSummary(const std::string& summary, const std::vector<std::filesystem::path>& failed)
+{
+    size_t line{ m_editor->GetStrCount() };
+    m_editor->AddLine(false, line++, utf8::utf8to16(summary));
+    for (auto& file : failed)
+        m_editor->AddLine(false, line++, utf8::utf8to16("  not written: " + file.u8string()));
+
+    m_editor->ClearModifyFlag();
+    return Refresh();
+}
+
+bool EditorWnd::GotoFoundInFile()
+{
+    //file name line goes to its first match
+    auto it = m_foundInFiles.lower_bound(m_firstLine + m_cursory);
+    if (it == m_foundInFiles.end())
+        return true;
+
+    auto& [line, found] = *it;
+    _GotoXY(0, line);
+
+    auto& editorApp = reinterpret_cast<EditorApp&>(Application::getInstance());
+    auto [t, parser] = LexParser::GetFileType(found.file);
+    if (!editorApp.OpenFile(found.file, parser, FileDialog::s_vars.cpName))
+        return false;
+
+    std::error_code ec;
+    auto wnd = reinterpret_cast<EditorWnd*>(editorApp.GetEditorWnd(std::filesystem::canonical(found.file, ec)));
+    if (!wnd)
+        return false;
+
+    //found position is in symbols, it is converted to column
+    auto& match = found.match;
+    wnd->ShowFound(wnd->m_editor->GetColumn(match.line, match.pos), match.line, match.size, true);
+    return wnd->Repaint();
 }
 
 bool EditorWnd::CheckFileChanging() try
@@ -50,9 +50,15 @@ bool EditorWnd::DlgGoto([[maybe_unused]]input_t cmd)
 bool EditorWnd::DlgFind([[maybe_unused]] input_t cmd)
 {
     FindDialog dlg(false);
+    //variables are changed with incremental search
+    auto vars = FindDialog::s_vars;
+    IncFindStart();
     auto ret = dlg.Activate();
+    if (ret != ID_OK)
+        FindDialog::s_vars = vars;
+    bool found = IncFindEnd(ret == ID_OK);
     WndManager::getInstance().CheckRefresh();
-    if (ret == ID_OK)
+    if (ret == ID_OK && !found)
     {
         Find();
     }
@@ -182,10 +188,18 @@ bool EditorWnd::CtrlProperties([[maybe_unused]]input_t cmd)
     return true;
 }
 
-bool EditorWnd::CtrlFuncList(input_t cmd)
+bool EditorWnd::CtrlFuncList([[maybe_unused]]input_t cmd)
 {
-    LOG(DEBUG) << __FUNC__ << " not implemented";
-    Application::getInstance().SetErrorLine("Command not implemented");
+    if (!m_editor->IsParsingEnabled())
+    {
+        EditorApp::SetErrorLine("Function list is not available for this file");
+        return true;
+    }
+
+    FuncListDialog dlg(m_editor->GetFuncList(), m_firstLine + m_cursory);
+    auto ret = dlg.Activate();
+    if (ret == ID_OK)
+        _GotoXY(0, dlg.GetLine());
 
     return true;
 }
@@ -179,6 +179,8 @@ bool EditorWnd::EditBS([[maybe_unused]] input_t cmd)
 
 bool EditorWnd::EditEnter([[maybe_unused]] input_t cmd)
 {
+    if (m_foundWnd)
+        return GotoFoundInFile();
     if (m_readOnly)
         return true;
 
@@ -704,6 +706,49 @@ bool EditorWnd::EditPasteFromClipboard(input_t cmd)
     return rc;
 }
 
+bool EditorWnd::EditPasteTerminal(input_t cmd)
+{
+    if (m_readOnly)
+        return true;
+
+    std::vector<std::u16string> strArray;
+    if (!WndManager::getInstance().GetPaste(strArray))
+        return true;
+
+    LOG(DEBUG) << "    EditPasteTerminal " << std::hex << cmd << std::dec << " lines=" << strArray.size();
+    TryDeleteSelectedBlock();
+
+    size_t x = m_xOffset + m_cursorx;
+    size_t y = m_firstLine + m_cursory;
+
+    //tab is expanded to next tab position as typed one
+    size_t t = m_editor->GetTab();
+    char16_t fill = m_editor->GetSaveTab() ? S_TAB : ' ';
+    size_t pos = x;
+    for (auto& str : strArray)
+    {
+        std::u16string out;
+        for (auto c : str)
+            if (c == S_TAB)
+                out.resize((pos + out.size() + t) - (pos + out.size() + t) % t - pos, fill);
+            else
+                out += c;
+        str = std::move(out);
+        pos = 0;
+    }
+
+    //text is inserted as one block without auto indent
+    bool rc = PasteSelected(strArray, select_t::stream);
+    ChangeSelected(select_change::clear);
+
+    //cursor to the end of pasted text
+    if (strArray.size() > 1)
+        x = 0;
+    x += strArray.back().size();
+    rc = _GotoXY(x, y + strArray.size() - 1) && rc;
+    return rc;
+}
+
 bool EditorWnd::Reload([[maybe_unused]]input_t cmd)
 {
     //LOG(DEBUG) << "    Reload";
@@ -746,9 +791,6 @@ bool EditorWnd::Replace([[maybe_unused]] input_t cmd)
     auto prevMenu = Application::getInstance().SetAccessMenu(g_replaceMenu);
     WndManager::getInstance().Refresh();
 
-    size_t begin = m_firstLine + m_cursory;
-    size_t strCount = m_editor->GetStrCount();
-    
     bool userBreak{};
     bool reverce{};
     bool prompt{true};
@@ -797,8 +839,10 @@ bool EditorWnd::Replace([[maybe_unused]] input_t cmd)
     };
 
     size_t count{};
-    size_t progress{};
     size_t fx{}, fy{}, fs{};
+    bool oneByOne{};
+    size_t begin{};
+    size_t progress{};
     while (1)
     {
         bool found{};
@@ -857,22 +901,42 @@ bool EditorWnd::Replace([[maybe_unused]] input_t cmd)
             EditorApp::SetHelpLine("Replace. Press any key for cancel.");
         }
 
-        if (!prompt)
+        if (!prompt && !oneByOne)
         {
-            if (++progress == 1000)
+            //all rest strings in one pass
+            size_t prevCount{ count };
+            if (ReplaceAll(count, userBreak) || userBreak)
+                break;
+            if (count != prevCount)
             {
-                progress = 0;
-                userBreak = UpdateProgress((m_foundY - begin) * 99 / (strCount - begin));
-
-                if (userBreak)
-                    break;
+                EditorApp::SetErrorLine("Replace error");
+                break;
             }
+
+            //without match index strings are replaced one by one
+            LOG(DEBUG) << "    Replace one by one";
+            oneByOne = true;
+            begin = m_foundY;
         }
 
+        if (oneByOne && ++progress == 1000)
+        {
+            progress = 0;
+            size_t strCount = m_editor->GetStrCount();
+            userBreak = UpdateProgress((m_foundY - begin) * 99 / std::max<size_t>(strCount - begin, 1));
+            if (userBreak)
+                break;
+        }
+
+        size_t len{ FindDialog::s_vars.findStrW.size() };
+        std::u16string replace{ FindDialog::s_vars.replaceStrW };
+        if (FindDialog::s_vars.regex && !GetRegexReplace(len, replace))
+            break;
+
         ++count;
-        [[maybe_unused]]bool rc = ReplaceSubstr(m_foundY, m_foundX, FindDialog::s_vars.findStrW.size(), FindDialog::s_vars.replaceStrW);
+        [[maybe_unused]]bool rc = ReplaceSubstr(m_foundY, m_foundX, len, replace);
         
-        m_foundSize = FindDialog::s_vars.replaceStrW.size();
+        m_foundSize = replace.size();
         _GotoXY(m_foundX + m_foundSize, m_foundY);
     }
 
@@ -930,6 +930,8 @@ bool EditorWnd::FindUpWord([[maybe_unused]] input_t cmd)
     }
 
     FindDialog::SaveToFindList(utf8::utf16to8(FindDialog::s_vars.findStrW));
+    //word is searched as plain string
+    FindDialog::s_vars.regex = false;
 
     return FindUp();
 }
@@ -943,10 +945,68 @@ bool EditorWnd::FindDownWord([[maybe_unused]] input_t cmd)
     }
 
     FindDialog::SaveToFindList(utf8::utf16to8(FindDialog::s_vars.findStrW));
+    //word is searched as plain string
+    FindDialog::s_vars.regex = false;
 
     return FindDown();
 }
 
+bool EditorWnd::Highlight(input_t cmd)
+{
+    if (K_GET_CODE(cmd) != 0)
+        m_highlight.clear();
+    else
+    {
+        std::u16string str;
+        if (!GetWord(str))
+        {
+            EditorApp::SetErrorLine("Nothing to highlight");
+            return false;
+        }
+
+        //removed string leaves empty slot, so other strings keep their colors
+        if (auto it = std::find(m_highlight.begin(), m_highlight.end(), str); it != m_highlight.end())
+            it->clear();
+        else if (auto slot = std::find(m_highlight.begin(), m_highlight.end(), std::u16string{}); slot != m_highlight.end())
+            *slot = std::move(str);
+        else
+            m_highlight.push_back(std::move(str));
+
+        if (std::all_of(m_highlight.cbegin(), m_highlight.cend(), [](const std::u16string& s) { return s.empty(); }))
+            m_highlight.clear();
+    }
+
+    m_highlightCase = FindDialog::s_vars.checkCase;
+    m_highlightFinder.reset();
+    if (!m_highlight.empty())
+    {
+        MultiStrFinder finder{ !m_highlightCase };
+        for (size_t i = 0; i < m_highlight.size(); ++i)
+            if (!m_highlight[i].empty())
+                Editor::AddMultiStr(finder, m_highlight[i], i, m_highlightCase, [](char16_t c, std::string& encoded) {
+                    utf8::unchecked::append(static_cast<uint32_t>(c), std::back_inserter(encoded));
+                    return true;
+                });
+        if (finder.Build())
+            m_highlightFinder = std::move(finder);
+    }
+
+    InvalidateRect(0, 0, m_clientSizeX, m_clientSizeY);
+    Repaint();
+
+    return true;
+}
+
+bool EditorWnd::HighlightUp([[maybe_unused]] input_t cmd)
+{
+    return FindHighlight(true);
+}
+
+bool EditorWnd::HighlightDown([[maybe_unused]] input_t cmd)
+{
+    return FindHighlight(false);
+}
+
 bool EditorWnd::Repeat(input_t cmd)
 {
     if (!FindDialog::s_vars.replaceMode)
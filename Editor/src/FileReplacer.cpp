@@ -0,0 +1,345 @@
+/*
+FreeBSD License
+
+Copyright (c) 2020-2021 vikonix: valeriy.kovalev.software@gmail.com
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "FileReplacer.h"
+#include "utils/logger.h"
+#include "utils/SymbolType.h"
+#include "utils/CpConverter.h"
+#include "utfcpp/utf8.h"
+
+#include <algorithm>
+#include <fstream>
+
+
+namespace _Editor
+{
+
+FileReplacer::FileReplacer(const std::u16string& toFind, const std::u16string& replace, const std::string& cp, bool checkCase, bool findWord, bool regex)
+    : FileSearcher(toFind, cp, checkCase, findWord)
+    , m_replace{ replace }
+    , m_regex{ regex }
+{
+    if (m_regex)
+    {
+        m_replaceU8 = utf8::utf16to8(m_replace);
+        Regex check{ utf8::utf16to8(m_toFind), m_checkCase };
+        m_error = check.GetError();
+    }
+    else if (m_toFind.empty())
+        m_error = "Search string empty";
+
+    m_findStr = m_toFind;
+    if (!m_checkCase)
+        std::transform(m_findStr.begin(), m_findStr.end(), m_findStr.begin(), [](char16_t c) { return std::towupper(c); });
+    m_searcher = std::make_unique<searcher_t>(m_findStr.cbegin(), m_findStr.cend());
+}
+
+std::vector<path_t> FileReplacer::GetFailed()
+{
+    std::unique_lock lock{ m_failedMutex };
+    return m_failed;
+}
+
+bool FileReplacer::ScanFile(File& file, ScanBuff& buff)
+{
+    //temporary file of other worker
+    if (file.path.extension() == c_tmpExt)
+        return false;
+
+    //link is replaced in its target file and each real file only once
+    std::error_code ec;
+    path_t target{ std::filesystem::canonical(file.path, ec) };
+    if (ec)
+        target = file.path;
+    {
+        std::unique_lock lock{ m_targetMutex };
+        if (!m_targets.insert(target).second)
+            return false;
+    }
+
+    path_t tmpPath{ target };
+    tmpPath += c_tmpExt;
+
+    bool rc{};
+    try
+    {
+        rc = ReplaceFile(file, buff, target, tmpPath);
+    }
+    catch (...)
+    {
+        LOG(ERROR) << "replace error file=" << file.path.u8string();
+        std::filesystem::remove(tmpPath, ec);
+
+        std::unique_lock lock{ m_failedMutex };
+        m_failed.push_back(file.path);
+        return false;
+    }
+
+    if (rc)
+        m_replaced += file.count;
+    return rc;
+}
+
+size_t FileReplacer::ReplaceStr(const std::u16string& str, const std::u16string& findStr, size_t begin, size_t end, Regex* regex, std::u16string& out)
+{
+    auto isWord = [&str, begin, end](size_t offset, size_t len) {
+        return (offset == begin || GetSymbolType(str[offset - 1]) != symbol_t::alnum)
+            && (offset + len >= end || GetSymbolType(str[offset + len]) != symbol_t::alnum);
+    };
+
+    out.clear();
+    size_t count{};
+    size_t last{ begin };
+    if (!regex)
+    {
+        size_t size{ m_findStr.size() };
+        auto itBegin = findStr.cbegin() + begin;
+        auto itEnd = findStr.cbegin() + end;
+        while (itBegin != itEnd)
+        {
+            auto itFound = std::search(itBegin, itEnd, *m_searcher);
+            if (itFound == itEnd)
+                break;
+
+            size_t offset = std::distance(findStr.cbegin(), itFound);
+            if (!m_findWord || isWord(offset, size))
+            {
+                out.append(str, last, offset - last);
+                out += m_replace;
+                last = offset + size;
+                ++count;
+                itBegin = itFound + size;
+            }
+            else
+                itBegin = itFound + 1;
+        }
+    }
+    else
+    {
+        //regex works with UTF-8 string, offset[column] is position in it
+        std::string u8str;
+        std::vector<size_t> offset(end - begin + 1);
+        for (size_t i = begin; i < end; ++i)
+        {
+            offset[i - begin] = u8str.size();
+            utf8::unchecked::append(static_cast<uint32_t>(str[i]), std::back_inserter(u8str));
+        }
+        offset[end - begin] = u8str.size();
+
+        if (!regex->Search(u8str))
+            return 0;
+
+        auto column = [&offset, begin](size_t pos) {
+            return begin + std::distance(offset.cbegin(), std::lower_bound(offset.cbegin(), offset.cend(), pos));
+        };
+
+        match_t match;
+        size_t pos{};
+        while (regex->Match(u8str, pos, match))
+        {
+            auto [b, e] = match[0];
+            size_t bx = column(b);
+            size_t ex = column(e);
+
+            //skip empty matches
+            if (e > b && (!m_findWord || isWord(bx, ex - bx)))
+            {
+                out.append(str, last, bx - last);
+                out += utf8::utf8to16(Regex::Expand(u8str, match, m_replaceU8));
+                last = ex;
+                ++count;
+                pos = e;
+                continue;
+            }
+
+            if (bx >= end)
+                break;
+            pos = offset[bx + 1 - begin];
+        }
+    }
+
+    if (count)
+        out.append(str, last, end - last);
+    return count;
+}
+
+bool FileReplacer::ReplaceFile(File& file, ScanBuff& buff, const path_t& target, const path_t& tmpPath)
+{
+    std::ifstream fileStream{ target, std::ios::binary };
+    if (!fileStream)
+        return false;
+
+    buff.SetCp(m_cp);
+
+    //regex keeps DFA cache so it is own for each thread
+    std::unique_ptr<Regex> regex;
+    if (m_regex)
+        regex = std::make_unique<Regex>(utf8::utf16to8(m_toFind), m_checkCase);
+
+    //blocks without string are not converted
+    std::optional<StrFinder> finder;
+    if (!m_regex && buff.rawData)
+        finder = Editor::MakeStrFinder(m_toFind, m_checkCase, *buff.converter);
+
+    //the original is not touched until the first replacement
+    std::ofstream out;
+    size_t offset{};    //file position of data
+    auto openOut = [&]() {
+        out.open(tmpPath, std::ios::binary | std::ios::trunc);
+        std::ifstream in{ target, std::ios::binary };
+        for (size_t size = offset; size && in && out;)
+        {
+            in.read(buff.buff.data(), std::min(size, buff.buff.size()));
+            auto read = static_cast<size_t>(in.gcount());
+            out.write(buff.buff.data(), read);
+            size -= read;
+        }
+        return out.good();
+    };
+
+    std::string data;
+    std::u16string line;
+    std::u16string upper;
+    std::u16string newStr;
+    std::string cpStr;
+    size_t count{};
+    bool rc{ true };
+    for (bool eof{}, first{ true }; rc && !eof; first = false)
+    {
+        fileStream.read(buff.buff.data(), buff.buff.size());
+        data.append(buff.buff.data(), static_cast<size_t>(fileStream.gcount()));
+        eof = fileStream.eof();
+        if (first && !m_binary && IsBinaryData(data))
+            return false;
+
+        //only full lines are processed, CR can be the first part of CR+LF
+        size_t size{ data.size() };
+        if (!eof)
+        {
+            size_t pos = data.find_last_of("\r\n");
+            if (pos != std::string::npos && pos + 1 == data.size() && data[pos] == '\r')
+                pos = pos ? data.find_last_of("\r\n", pos - 1) : std::string::npos;
+            if (pos == std::string::npos)
+                continue;
+            size = pos + 1;
+        }
+
+        //block without string is copied as is
+        bool scan = !finder || finder->Find(std::string_view(data.data(), size)) != StrFinder::npos;
+
+        //lines with wrong symbols are left as is
+        auto& u16buff = buff.u16buff;
+        bool valid = scan && buff.converter->Convert(std::string_view(data.data(), size), u16buff);
+        if (valid && !m_checkCase)
+        {
+            buff.upperBuff.resize(u16buff.size());
+            std::transform(u16buff.cbegin(), u16buff.cend(), buff.upperBuff.begin(), [](char16_t c) { return std::towupper(c); });
+        }
+
+        size_t written{};
+        for (size_t b{}, u{}; rc && scan && b < size;)
+        {
+            size_t e = std::min(data.find_first_of("\r\n", b), size);
+            size_t eol = e == size ? 0 : (data[e] == '\r' && e + 1 < size && data[e + 1] == '\n' ? 2 : 1);
+
+            size_t n{};
+            if (valid)
+            {
+                size_t ue = std::min(u16buff.find_first_of(u"\r\n", u), u16buff.size());
+                n = ReplaceStr(u16buff, m_checkCase ? u16buff : buff.upperBuff, u, ue, regex.get(), newStr);
+                u = ue + eol;
+            }
+            else if (buff.converter->Convert(std::string_view(data.data() + b, e - b), line))
+            {
+                if (!m_checkCase)
+                {
+                    upper.resize(line.size());
+                    std::transform(line.cbegin(), line.cend(), upper.begin(), [](char16_t c) { return std::towupper(c); });
+                }
+                n = ReplaceStr(line, m_checkCase ? line : upper, 0, line.size(), regex.get(), newStr);
+            }
+
+            if (n && m_dryRun)
+                count += n;
+            else if (n)
+            {
+                if (!out.is_open())
+                    rc = openOut();
+
+                buff.converter->Convert(newStr, cpStr);
+                out.write(data.data() + written, b - written);
+                out.write(cpStr.data(), cpStr.size());
+                written = e;
+                count += n;
+            }
+            b = e + eol;
+        }
+
+        if (out.is_open())
+        {
+            out.write(data.data() + written, size - written);
+            rc = out.good();
+        }
+
+        offset += size;
+        data.erase(0, size);
+        if (m_cancel)
+            rc = false;
+    }
+
+    fileStream.close();
+    if (m_dryRun)
+    {
+        file.count = count;
+        return rc && count;
+    }
+    if (!out.is_open())
+        return false;
+
+    out.close();
+    std::error_code ec;
+    if (rc && out)
+    {
+        std::filesystem::permissions(tmpPath, std::filesystem::status(target).permissions(), ec);
+        std::filesystem::rename(tmpPath, target, ec);
+        if (!ec)
+        {
+            file.count = count;
+            return true;
+        }
+    }
+
+    std::filesystem::remove(tmpPath, ec);
+    if (!m_cancel)
+    {
+        LOG(ERROR) << "replace write error file=" << file.path.u8string();
+        std::unique_lock lock{ m_failedMutex };
+        m_failed.push_back(file.path);
+    }
+    return false;
+}
+
+} //namespace _Editor
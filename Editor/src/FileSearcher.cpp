@@ -0,0 +1,282 @@
+/*
+FreeBSD License
+
+Copyright (c) 2020-2021 vikonix: valeriy.kovalev.software@gmail.com
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "FileSearcher.h"
+#include "utils/logger.h"
+#include "utfcpp/utf8.h"
+
+#include <algorithm>
+
+
+namespace _Editor
+{
+
+bool FileSearcher::Start(const path_t& path, const std::string& mask, bool recursive, filter_func filter)
+{
+    Stop();
+
+    m_mask = mask;
+    m_recursive = recursive;
+    m_filter = filter;
+
+    m_cancel = false;
+    m_walked = false;
+    m_queued = 0;
+    m_scanned = 0;
+    m_walkCount = 0;
+    m_walkedDirs.clear();
+    m_found.clear();
+    m_taken = 0;
+
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    m_workers.clear();
+    for (size_t i = 0; i < threads; ++i)
+        m_workers.push_back(std::make_unique<Worker>());
+
+    m_running = threads + 1;
+    m_walker = std::thread(&FileSearcher::Walk, this, path);
+    for (size_t i = 0; i < threads; ++i)
+        m_threads.emplace_back(&FileSearcher::Scan, this, i);
+
+    return true;
+}
+
+void FileSearcher::Stop()
+{
+    {
+        std::unique_lock lock{ m_waitMutex };
+        m_cancel = true;
+    }
+    m_waitCondition.notify_all();
+
+    if (m_walker.joinable())
+        m_walker.join();
+    for (auto& thread : m_threads)
+        thread.join();
+    m_threads.clear();
+}
+
+void FileSearcher::Walk(const path_t& path)
+{
+    try
+    {
+        [[maybe_unused]] bool rc = WalkDir(path);
+    }
+    catch (...)
+    {
+        _assert(0);
+    }
+
+    {
+        std::unique_lock lock{ m_waitMutex };
+        m_walked = true;
+    }
+    m_waitCondition.notify_all();
+    --m_running;
+}
+
+bool FileSearcher::WalkDir(const path_t& path)
+{
+    //error in one directory doesn't stop walking
+    std::vector<path_t> dirs;
+    try
+    {
+        _Utils::DirectoryList dirList;
+
+        dirList.SetMask(path);
+        dirList.SetMask(m_mask);
+
+        //links to directory can make a loop, so real directory is walked once
+        std::error_code ec;
+        auto realPath = std::filesystem::canonical(dirList.GetPath(), ec);
+        if (!ec && !m_walkedDirs.insert(realPath).second)
+            return !m_cancel;
+
+        {
+            std::unique_lock lock{ m_foundMutex };
+            m_curPath = dirList.GetPath();
+        }
+        dirList.Scan();
+
+        for (auto& file : dirList.GetFileList())
+        {
+            if (m_cancel)
+                return false;
+            if (m_filter && !m_filter(file.path()))
+                continue;
+
+            {
+                //don't go too far from workers
+                std::unique_lock lock{ m_waitMutex };
+                m_waitCondition.wait(lock, [this]() { return m_cancel || m_queued < c_maxQueued; });
+                if (m_cancel)
+                    return false;
+                ++m_queued;
+            }
+
+            auto& worker = *m_workers[m_walkCount % m_workers.size()];
+            {
+                std::unique_lock lock{ worker.mutex };
+                worker.files.push_back({ m_walkCount++, file.path(), 0, {} });
+            }
+            m_waitCondition.notify_one();
+        }
+
+        if (m_recursive)
+            for (auto& dir : dirList.GetDirList())
+                if (dir != "..")
+                    dirs.push_back(dirList.GetPath() / utf8::utf8to16(dir));
+    }
+    catch (const std::exception& ex)
+    {
+        LOG(ERROR) << __FUNC__ << " path=" << path.u8string() << " exception: " << ex.what();
+    }
+
+    for (auto& dir : dirs)
+        if (!WalkDir(dir))
+            return false;
+
+    return !m_cancel;
+}
+
+std::optional<FileSearcher::File> FileSearcher::PopFile(size_t worker)
+{
+    //own queue first and then steal from end of other queue
+    for (size_t i = 0; i < m_workers.size(); ++i)
+    {
+        auto& queue = *m_workers[(worker + i) % m_workers.size()];
+        std::unique_lock lock{ queue.mutex };
+        if (queue.files.empty())
+            continue;
+
+        File file;
+        if (i == 0)
+        {
+            file = std::move(queue.files.front());
+            queue.files.pop_front();
+        }
+        else
+        {
+            file = std::move(queue.files.back());
+            queue.files.pop_back();
+        }
+        lock.unlock();
+
+        bool full;
+        {
+            std::unique_lock waitLock{ m_waitMutex };
+            full = m_queued-- == c_maxQueued;
+        }
+        //walker waits for free place
+        if (full)
+            m_waitCondition.notify_all();
+        return file;
+    }
+
+    return std::nullopt;
+}
+
+bool FileSearcher::ScanFile(File& file, ScanBuff& buff)
+{
+    bool found = Editor::ScanFile(file.path, m_toFind, m_cp, m_checkCase, m_findWord, buff,
+        [this]() { return !m_cancel; }, m_allMatches ? &file.matches : nullptr, m_binary);
+    if (found)
+        file.count = m_allMatches ? file.matches.size() : 1;
+    return found;
+}
+
+void FileSearcher::Scan(size_t worker)
+{
+    ScanBuff buff;
+    while (!m_cancel)
+    {
+        auto file = PopFile(worker);
+        if (!file)
+        {
+            std::unique_lock lock{ m_waitMutex };
+            if (m_walked && m_queued == 0)
+                break;
+            m_waitCondition.wait(lock, [this]() { return m_cancel || m_walked || m_queued != 0; });
+            continue;
+        }
+
+        bool found{};
+        try
+        {
+            found = ScanFile(*file, buff);
+        }
+        catch (...)
+        {
+            LOG(ERROR) << "scan error file=" << file->path.u8string();
+        }
+
+        ++m_scanned;
+        if (found)
+        {
+            std::unique_lock lock{ m_foundMutex };
+            m_found.push_back(std::move(*file));
+        }
+    }
+
+    --m_running;
+}
+
+path_t FileSearcher::GetCurPath()
+{
+    std::unique_lock lock{ m_foundMutex };
+    return m_curPath;
+}
+
+std::vector<FileSearcher::found_t> FileSearcher::GetFound()
+{
+    std::vector<found_t> found;
+
+    //matches are given only once
+    std::unique_lock lock{ m_foundMutex };
+    for (; m_taken < m_found.size(); ++m_taken)
+        found.emplace_back(m_found[m_taken].path, m_found[m_taken].count, std::move(m_found[m_taken].matches));
+    return found;
+}
+
+std::vector<path_t> FileSearcher::GetResult()
+{
+    std::vector<File> files;
+    {
+        std::unique_lock lock{ m_foundMutex };
+        for (auto& file : m_found)
+            files.push_back({ file.n, file.path, file.count, {} });
+    }
+
+    std::sort(files.begin(), files.end(), [](const File& f1, const File& f2) { return f1.n < f2.n; });
+
+    std::vector<path_t> found;
+    found.reserve(files.size());
+    for (auto& file : files)
+        found.push_back(std::move(file.path));
+    return found;
+}
+
+} //namespace _Editor
@@ -0,0 +1,407 @@
+/*
+FreeBSD License
+
+Copyright (c) 2020-2021 vikonix: valeriy.kovalev.software@gmail.com
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "LexPairIndex.h"
+
+#include <algorithm>
+
+
+namespace _Editor
+{
+
+int LexPairIndex::GetPairType(char c, int& d)
+{
+    d = 1;
+    switch (c)
+    {
+    case ')':
+        d = -1;
+        [[fallthrough]];
+    case '(':
+        return 0;
+    case '}':
+        d = -1;
+        [[fallthrough]];
+    case '{':
+        return 1;
+    case ']':
+        d = -1;
+        [[fallthrough]];
+    case '[':
+        return 2;
+    case '>':
+        d = -1;
+        [[fallthrough]];
+    case '<':
+        return 3;
+    default:
+        return -1;
+    }
+}
+
+template<typename F>
+void LexPairIndex::ScanLex(const std::string& lex, bool& comment, F func)
+{
+    //brackets between open and close comment are skipped
+    for (char c : lex)
+    {
+        if (c == 'O')
+            comment = true;
+        else if (c == 'C')
+            comment = false;
+        else if (!comment)
+        {
+            int d;
+            int type = GetPairType(c, d);
+            if (type >= 0)
+                func(type, d);
+        }
+    }
+}
+
+LexPairIndex::IndexNode LexPairIndex::CalcLeaf(const lex_map& lexMap, size_t begin, size_t strCount)
+{
+    IndexNode node;
+    node.strCount = strCount;
+
+    auto first = lexMap.lower_bound(begin);
+    for (size_t state = 0; state < 2; ++state)
+    {
+        bool comment = state != 0;
+        auto& pair = node.pair[state];
+        for (auto it = first; it != lexMap.end() && it->first < begin + strCount; ++it)
+            ScanLex(it->second, comment, [&pair](int type, int d) {
+                pair[type].sum += d;
+                pair[type].minPre = std::min(pair[type].minPre, pair[type].sum);
+            });
+        node.exit[state] = comment;
+    }
+
+    return node;
+}
+
+LexPairIndex::IndexNode LexPairIndex::Merge(const IndexNode& left, const IndexNode& right)
+{
+    IndexNode node;
+    node.strCount = left.strCount + right.strCount;
+
+    for (size_t state = 0; state < 2; ++state)
+    {
+        bool mid = left.exit[state];
+        node.exit[state] = right.exit[mid];
+        for (size_t type = 0; type < c_pairTypes; ++type)
+        {
+            const auto& l = left.pair[state][type];
+            const auto& r = right.pair[mid][type];
+            node.pair[state][type] = { l.sum + r.sum, std::min(l.minPre, l.sum + r.minPre) };
+        }
+    }
+
+    return node;
+}
+
+void LexPairIndex::Build(const lex_map& lexMap)
+{
+    size_t strCount = lexMap.empty() ? 0 : lexMap.rbegin()->first + 1;
+    size_t leaves = std::max<size_t>(1, (strCount + c_leafLines - 1) / c_leafLines);
+
+    m_leaf.clear();
+    m_leaf.reserve(leaves);
+    for (size_t i = 0; i < leaves; ++i)
+        m_leaf.push_back(CalcLeaf(lexMap, i * c_leafLines, std::min(c_leafLines, strCount - i * c_leafLines)));
+
+    m_tree.assign(m_leaf.size() * 4, {});
+    BuildTree(1, 0, m_leaf.size());
+    m_valid = true;
+}
+
+void LexPairIndex::BuildTree(size_t node, size_t l, size_t r)
+{
+    if (r - l == 1)
+    {
+        m_tree[node] = m_leaf[l];
+        return;
+    }
+
+    size_t mid = (l + r) / 2;
+    BuildTree(node * 2, l, mid);
+    BuildTree(node * 2 + 1, mid, r);
+    m_tree[node] = Merge(m_tree[node * 2], m_tree[node * 2 + 1]);
+}
+
+void LexPairIndex::UpdateTree(size_t node, size_t l, size_t r, size_t leaf)
+{
+    if (r - l == 1)
+    {
+        m_tree[node] = m_leaf[l];
+        return;
+    }
+
+    size_t mid = (l + r) / 2;
+    if (leaf < mid)
+        UpdateTree(node * 2, l, mid, leaf);
+    else
+        UpdateTree(node * 2 + 1, mid, r, leaf);
+    m_tree[node] = Merge(m_tree[node * 2], m_tree[node * 2 + 1]);
+}
+
+void LexPairIndex::UpdateLeaf(const lex_map& lexMap, size_t leaf, size_t begin)
+{
+    size_t strCount = m_leaf[leaf].strCount;
+    if (strCount > c_leafLines * 2)
+    {
+        //split big leaf and rebuild tree without full rescan
+        std::vector<IndexNode> split;
+        for (size_t l = 0; l < strCount; l += c_leafLines)
+            split.push_back(CalcLeaf(lexMap, begin + l, std::min(c_leafLines, strCount - l)));
+
+        m_leaf.erase(m_leaf.begin() + leaf);
+        m_leaf.insert(m_leaf.begin() + leaf, split.begin(), split.end());
+        m_tree.assign(m_leaf.size() * 4, {});
+        BuildTree(1, 0, m_leaf.size());
+    }
+    else
+    {
+        m_leaf[leaf] = CalcLeaf(lexMap, begin, strCount);
+        UpdateTree(1, 0, m_leaf.size(), leaf);
+    }
+}
+
+size_t LexPairIndex::GetLeaf(size_t& line, bool& state) const
+{
+    //line will be converted to offset from leaf begin
+    state = false;
+    size_t node{ 1 };
+    size_t l{};
+    size_t r{ m_leaf.size() };
+    while (r - l > 1)
+    {
+        size_t mid = (l + r) / 2;
+        const auto& left = m_tree[node * 2];
+        if (line < left.strCount)
+        {
+            node = node * 2;
+            r = mid;
+        }
+        else
+        {
+            line -= left.strCount;
+            state = left.exit[state];
+            node = node * 2 + 1;
+            l = mid;
+        }
+    }
+
+    return l;
+}
+
+void LexPairIndex::ChangeLine(const lex_map& lexMap, size_t line)
+{
+    if (!m_valid)
+        return;
+
+    size_t offset{ line };
+    bool state;
+    size_t leaf = GetLeaf(offset, state);
+    auto& node = m_leaf[leaf];
+    node.strCount = std::max(node.strCount, offset + 1);
+    UpdateLeaf(lexMap, leaf, line - offset);
+}
+
+void LexPairIndex::AddLine(const lex_map& lexMap, size_t line)
+{
+    if (!m_valid)
+        return;
+
+    size_t offset{ line };
+    bool state;
+    size_t leaf = GetLeaf(offset, state);
+    auto& node = m_leaf[leaf];
+    node.strCount = std::max(node.strCount, offset) + 1;
+    UpdateLeaf(lexMap, leaf, line - offset);
+}
+
+void LexPairIndex::DelLine(const lex_map& lexMap, size_t line)
+{
+    if (!m_valid)
+        return;
+
+    size_t offset{ line };
+    bool state;
+    size_t leaf = GetLeaf(offset, state);
+    auto& node = m_leaf[leaf];
+    if (offset < node.strCount)
+    {
+        --node.strCount;
+        UpdateLeaf(lexMap, leaf, line - offset);
+    }
+}
+
+std::optional<size_t> LexPairIndex::ScanDown(const lex_map& lexMap, size_t begin, size_t end, size_t from,
+    int type, bool comment, int& count)
+{
+    for (auto it = lexMap.lower_bound(begin); it != lexMap.end() && it->first < end; ++it)
+    {
+        bool found{};
+        bool check{ it->first >= from };
+        ScanLex(it->second, comment, [&](int t, int d) {
+            if (check && !found && t == type)
+                found = (count += d) == 0;
+        });
+        if (found)
+            return it->first;
+    }
+    return std::nullopt;
+}
+
+std::optional<size_t> LexPairIndex::ScanUp(const lex_map& lexMap, size_t begin, size_t end,
+    int type, bool comment, int& count)
+{
+    //get comment state for each line
+    std::vector<std::pair<lex_map::const_iterator, bool>> strList;
+    for (auto it = lexMap.lower_bound(begin); it != lexMap.end() && it->first < end; ++it)
+    {
+        strList.emplace_back(it, comment);
+        ScanLex(it->second, comment, [](int, int) {});
+    }
+
+    std::vector<int> pairs;
+    for (auto line = strList.rbegin(); line != strList.rend(); ++line)
+    {
+        auto& [it, state] = *line;
+        pairs.clear();
+        ScanLex(it->second, state, [&pairs, type](int t, int d) {
+            if (t == type)
+                pairs.push_back(d);
+        });
+        for (auto d = pairs.rbegin(); d != pairs.rend(); ++d)
+            if ((count -= *d) == 0)
+                return it->first;
+    }
+    return std::nullopt;
+}
+
+std::optional<size_t> LexPairIndex::FindDown(size_t node, size_t l, size_t r, size_t from,
+    int type, bool state, size_t begin, int& count, bool& leafState, size_t& leafBegin) const
+{
+    if (r <= from)
+        return std::nullopt;
+
+    const auto& sum = m_tree[node].pair[state][type];
+    if (l >= from && count + sum.minPre > 0)
+    {
+        //no pair in this node
+        count += sum.sum;
+        return std::nullopt;
+    }
+
+    if (r - l == 1)
+    {
+        leafState = state;
+        leafBegin = begin;
+        return l;
+    }
+
+    size_t mid = (l + r) / 2;
+    const auto& left = m_tree[node * 2];
+    if (auto leaf = FindDown(node * 2, l, mid, from, type, state, begin, count, leafState, leafBegin))
+        return leaf;
+    return FindDown(node * 2 + 1, mid, r, from, type, left.exit[state], begin + left.strCount, count, leafState, leafBegin);
+}
+
+std::optional<size_t> LexPairIndex::FindUp(size_t node, size_t l, size_t r, size_t to,
+    int type, bool state, size_t begin, int& count, bool& leafState, size_t& leafBegin) const
+{
+    if (l >= to)
+        return std::nullopt;
+
+    const auto& sum = m_tree[node].pair[state][type];
+    if (r <= to && sum.sum - sum.minPre < count)
+    {
+        //no pair in this node
+        count -= sum.sum;
+        return std::nullopt;
+    }
+
+    if (r - l == 1)
+    {
+        leafState = state;
+        leafBegin = begin;
+        return l;
+    }
+
+    size_t mid = (l + r) / 2;
+    const auto& left = m_tree[node * 2];
+    if (auto leaf = FindUp(node * 2 + 1, mid, r, to, type, left.exit[state], begin + left.strCount, count, leafState, leafBegin))
+        return leaf;
+    return FindUp(node * 2, l, mid, to, type, state, begin, count, leafState, leafBegin);
+}
+
+std::optional<size_t> LexPairIndex::FindPair(const lex_map& lexMap, char c, size_t line, int count)
+{
+    int d;
+    int type = GetPairType(c, d);
+    if (type < 0 || count <= 0)
+        return std::nullopt;
+
+    if (!m_valid)
+        Build(lexMap);
+
+    bool state;
+    size_t leafBegin;
+    if (d > 0)
+    {
+        //looking in next lines
+        size_t offset{ line + 1 };
+        size_t leaf = GetLeaf(offset, state);
+        if (offset >= m_leaf[leaf].strCount)
+            return std::nullopt;
+
+        leafBegin = line + 1 - offset;
+        if (auto found = ScanDown(lexMap, leafBegin, leafBegin + m_leaf[leaf].strCount, line + 1, type, state, count))
+            return found;
+
+        if (auto found = FindDown(1, 0, m_leaf.size(), leaf + 1, type, false, 0, count, state, leafBegin))
+            return ScanDown(lexMap, leafBegin, leafBegin + m_leaf[*found].strCount, leafBegin, type, state, count);
+    }
+    else if (line > 0)
+    {
+        //looking in prev lines
+        size_t offset{ line - 1 };
+        size_t leaf = GetLeaf(offset, state);
+
+        leafBegin = line - 1 - offset;
+        if (auto found = ScanUp(lexMap, leafBegin, line, type, state, count))
+            return found;
+
+        if (auto found = FindUp(1, 0, m_leaf.size(), leaf, type, false, 0, count, state, leafBegin))
+            return ScanUp(lexMap, leafBegin, leafBegin + m_leaf[*found].strCount, type, state, count);
+    }
+
+    return std::nullopt;
+}
+
+} //namespace _Editor
@@ -177,6 +177,8 @@ bool LexParser::SetParseStyle(const std::string& style)
     m_recursiveString = false;
     m_parseStyle.clear();
     m_lexPosition.clear();
+    m_pairIndex.Clear();
+    m_funcPosition.clear();
 
     m_commentTest.reset();
     m_specialTest.reset();
@@ -279,19 +281,48 @@ bool LexParser::ScanStr(size_t line, std::string_view str, [[maybe_unused]]const
         return wstr;
     };
 
+    auto wstr = simpleConverter(str);
+    auto func = ScanFunc(wstr);
+    if (!func.empty())
+        m_funcPosition.emplace(line, std::move(func));
+
     std::string lexstr;
-    bool rc = LexicalParse(simpleConverter(str), lexstr);
+    bool rc = LexicalParse(wstr, lexstr);
 
     if (rc && !lexstr.empty())
     {
         //LOG(DEBUG) << "  collected lex types=" << lexstr;
 
         m_lexPosition.emplace(line, lexstr);
+        m_pairIndex.Clear();
     }
 
     return rc;
 }
 
+LexParser::LexState LexParser::GetLexState() const
+{
+    return { m_stringSymbol, m_cutLine, m_commentOpen, m_commentToggled };
+}
+
+void LexParser::SetLexState(const LexState& state)
+{
+    m_stringSymbol      = state.stringSymbol;
+    m_cutLine           = state.cutLine;
+    m_commentOpen       = state.commentOpen;
+    m_commentToggled    = state.commentToggled;
+}
+
+bool LexParser::MergeLexPosition(LexParser& parser)
+{
+    //lines of merged parser must not intersect with ours
+    m_lexPosition.merge(parser.m_lexPosition);
+    m_funcPosition.merge(parser.m_funcPosition);
+    m_pairIndex.Clear();
+    _assert(parser.m_lexPosition.empty() && parser.m_funcPosition.empty());
+    return true;
+}
+
 bool LexParser::GetColor(size_t line, const std::u16string& wstr, std::vector<color_t>& color, size_t len)
 {
     size_t strLen = Editor::UStrLen(wstr);
@@ -1051,6 +1082,7 @@ bool LexParser::ChangeStr(size_t line, const std::u16string& wstr, invalidate_t&
 
     CheckForConcatenatedLine(line);
     CheckForOpenComments(line);
+    SetFunc(line, ScanFunc(wstr));
 
     std::string lexstr;
     LexicalParse(wstr, lexstr);
@@ -1066,6 +1098,7 @@ bool LexParser::ChangeStr(size_t line, const std::u16string& wstr, invalidate_t&
             m_lexPosition[line] = lexstr;
         else if (it != m_lexPosition.end())
             m_lexPosition.erase(it);
+        m_pairIndex.ChangeLine(m_lexPosition, line);
 
         bool comment{};
         bool backslashPrev{};
@@ -1111,6 +1144,8 @@ bool LexParser::AddStr(size_t line, const std::u16string& wstr, invalidate_t& in
     //LOG(DEBUG) << "LexParser::AddStr l=" << line;
     
     CheckForOpenComments(line);
+    ShiftLines(m_funcPosition, line, true);
+    SetFunc(line, ScanFunc(wstr));
 
     std::string lexstr;
     LexicalParse(wstr, lexstr);
@@ -1154,6 +1189,7 @@ bool LexParser::DelStr(size_t line, invalidate_t& inv)
     }
 
     DeleteLexem(line);
+    ShiftLines(m_funcPosition, line, false);
 
     return true;
 }
@@ -1180,6 +1216,7 @@ bool LexParser::AddLexem(size_t line, const std::string& lexstr)
     if(!lexstr.empty())
         m_lexPosition[line] = lexstr;
 
+    m_pairIndex.AddLine(m_lexPosition, line);
     return true;
 }
 
@@ -1201,9 +1238,73 @@ bool LexParser::DeleteLexem(size_t line)
         it = i;
     }
 
+    m_pairIndex.DelLine(m_lexPosition, line);
     return true;
 }
 
+void LexParser::ShiftLines(lex_map& lexMap, size_t line, bool insert)
+{
+    auto it = lexMap.lower_bound(line);
+    if (!insert && it != lexMap.end() && it->first == line)
+        it = lexMap.erase(it);
+
+    lex_map tail;
+    while (it != lexMap.end())
+    {
+        auto node = lexMap.extract(it++);
+        if (insert)
+            ++node.key();
+        else
+            --node.key();
+        tail.insert(tail.end(), std::move(node));
+    }
+    lexMap.merge(tail);
+}
+
+std::string LexParser::ScanFunc(std::u16string_view str)
+{
+    //function definition begins from first column and has name before open bracket
+    //like: 'int main(', 'bool Editor::Load(' or 'def func('
+    if (str.empty() || m_commentOpen || SymbolType(str[0]) != lex_t::SYMBOL)
+        return {};
+
+    auto bracket = str.find('(');
+    if (bracket == std::u16string_view::npos)
+        return {};
+
+    auto prefix = str.substr(0, bracket);
+    if (prefix.find_first_of(u";=\"") != std::u16string_view::npos)
+        return {};
+
+    auto last = str.find_last_not_of(u" \t\r\n");
+    if (str[last] == ';')
+        return {};
+
+    auto end = prefix.find_last_not_of(u" \t");
+    if (end == std::u16string_view::npos)
+        return {};
+
+    size_t begin = end + 1;
+    while (begin > 0 && (SymbolType(prefix[begin - 1]) == lex_t::SYMBOL || prefix[begin - 1] == ':' || prefix[begin - 1] == '~'))
+        --begin;
+
+    auto name = prefix.substr(begin, end - begin + 1);
+    auto nameBegin = name.find_last_of(u":~");
+    auto ident = nameBegin == std::u16string_view::npos ? name : name.substr(nameBegin + 1);
+    if (ident.empty() || std::iswdigit(ident[0]) || IsKeyWord(ident))
+        return {};
+
+    return utf8::utf16to8(std::u16string(name));
+}
+
+void LexParser::SetFunc(size_t line, std::string&& name)
+{
+    if (!name.empty())
+        m_funcPosition[line] = std::move(name);
+    else
+        m_funcPosition.erase(line);
+}
+
 bool LexParser::CheckLexPair(const std::u16string& wstr, size_t& line, size_t& pos)
 {
     //LOG(DEBUG) << "CheckLexPair";
@@ -1229,7 +1330,6 @@ bool LexParser::CheckLexPair(const std::u16string& wstr, size_t& line, size_t& p
         return false;
 
     auto& [chPair, up] = pair->second;
-    auto posIt = m_lexPosition.lower_bound(line);
 
     int count = 1;
     if(!up)
@@ -1250,34 +1350,6 @@ bool LexParser::CheckLexPair(const std::u16string& wstr, size_t& line, size_t& p
                 return true;
             }
         }
-
-        //looking in next lines
-        bool skipComment{};
-        for (; posIt != m_lexPosition.end(); ++posIt)
-        {
-            if (posIt->first == line)
-                continue;
-            for (auto c : posIt->second)
-            {
-                if (c == 'O')
-                {
-                    //skip comment
-                    skipComment = true;
-                }
-                else if (skipComment)
-                {
-                    if (c == 'C')
-                        skipComment = false;
-                }
-                else if (c == chPair)
-                    --count;
-                else if (c == ch)
-                    ++count;
-
-                if (!count)
-                    goto GetStartCount;
-            }
-        }
     }
     else
     {
@@ -1297,68 +1369,18 @@ bool LexParser::CheckLexPair(const std::u16string& wstr, size_t& line, size_t& p
                 return true;
             }
         }
-
-        //looking in prev lines
-        for (; posIt != m_lexPosition.end(); --posIt)
-        {
-            if (posIt->first == line)
-                continue;
-
-            auto lex = posIt->second;
-            for (size_t i = lex.size() - 1; i < lex.size(); --i)//go through 0
-            {
-                char c = lex[i];
-                if (c == 'C')
-                {
-                    auto saveIt{ m_lexPosition.end() };
-                    size_t saveI{};
-                    bool end{};
-
-                    //LOG(DEBUG) << "Scan skip rem line=" << posIt->first << " pos=" << i;
-                    for (; posIt != m_lexPosition.end() && !end; --posIt)
-                    {
-                        const auto& lex1 = posIt->second;
-                        for (--i; i < lex1.size(); --i)
-                        {
-                            char c1 = lex1[i];
-                            if (c1 == 'O')
-                            {
-                                saveIt = posIt;
-                                saveI = i;
-                            }
-                            else if (c1 == 'C')
-                            {
-                                end = true;
-                                break;
-                            }
-                        }
-                    }
-
-                    if (saveIt == m_lexPosition.end())
-                        return false;
-
-                    posIt = saveIt;
-                    i = saveI;
-                    lex = saveIt->second;
-                    //LOG(DEBUG) << "Skip rem line=" << posIt->first << " pos=" << i;
-                }
-                else if (c == chPair)
-                    --count;
-                else if (c == ch)
-                    ++count;
-
-                if (!count)
-                    goto GetStartCount;
-            }
-        }
     }
-    return false;
 
-GetStartCount:
-    line = posIt->first;
-    const auto& lex = posIt->second;
+    //looking in next/prev lines
+    auto found = m_pairIndex.FindPair(m_lexPosition, static_cast<char>(ch), line, count);
+    if (!found)
+        return false;
+
+    line = *found;
+    const auto& lex = m_lexPosition[line];
 
     //goto begin of line and count brackets
+    count = 0;
     for (size_t i = lex.size() - 1; i < lex.size(); --i)//go through 0
     {
         char c = lex[i];
@@ -0,0 +1,266 @@
+/*
+FreeBSD License
+
+Copyright (c) 2020-2021 vikonix: valeriy.kovalev.software@gmail.com
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "MatchIndex.h"
+
+#include <algorithm>
+
+
+namespace _Editor
+{
+
+void MatchIndex::Start(const std::string& key, match_func func, std::optional<_Utils::StrFinder> finder)
+{
+    m_key = key;
+    m_func = func;
+    m_finder = std::move(finder);
+    Clear();
+}
+
+void MatchIndex::Truncate(size_t line)
+{
+    if (line >= m_scanLine)
+        return;
+
+    ApplyShift();
+    m_match.erase(LineBegin(line), m_match.end());
+    m_dirty.erase(std::lower_bound(m_dirty.begin(), m_dirty.end(), line), m_dirty.end());
+    m_scanLine = line;
+}
+
+std::vector<MatchIndex::Match>::iterator MatchIndex::LineBegin(size_t line)
+{
+    return std::lower_bound(m_match.begin(), m_match.end(), line, 
+        [](const Match& match, size_t l) { return match.line < l; });
+}
+
+std::vector<MatchIndex::Match>::const_iterator MatchIndex::LineBegin(size_t line) const
+{
+    return std::lower_bound(m_match.cbegin(), m_match.cend(), line,
+        [](const Match& match, size_t l) { return match.line < l; });
+}
+
+void MatchIndex::EraseLine(size_t line)
+{
+    auto it = LineBegin(line);
+    auto end = std::find_if(it, m_match.end(), [line](const Match& match) { return match.line != line; });
+    m_match.erase(it, end);
+}
+
+void MatchIndex::ApplyShift()
+{
+    if (m_shift == 0)
+        return;
+
+    //deleted lines are removed and next lines are moved in one pass
+    auto out = LineBegin(m_shift < 0 ? m_shiftLine + m_shift : m_shiftLine);
+    for (auto it = out; it != m_match.end(); ++it)
+        if (it->line >= m_shiftLine)
+        {
+            *out = *it;
+            out->line += m_shift;
+            ++out;
+        }
+    m_match.erase(out, m_match.end());
+
+    m_shiftLine = 0;
+    m_shift = 0;
+}
+
+void MatchIndex::ShiftDirty(size_t line, bool add)
+{
+    for (auto it = std::lower_bound(m_dirty.begin(), m_dirty.end(), line); it != m_dirty.end(); ++it)
+        add ? ++*it : --*it;
+}
+
+void MatchIndex::InsertLine(size_t line)
+{
+    ApplyShift();
+
+    line_match_t found;
+    m_func(line, found);
+
+    std::vector<Match> match;
+    match.reserve(found.size());
+    for (auto [x, size] : found)
+        match.push_back({ line, x, size });
+
+    m_match.insert(LineBegin(line), match.cbegin(), match.cend());
+}
+
+bool MatchIndex::IsScanned(size_t line) const
+{
+    return line < m_scanLine && !std::binary_search(m_dirty.cbegin(), m_dirty.cend(), line);
+}
+
+void MatchIndex::ChangeLine(size_t line)
+{
+    if (!IsScanned(line))
+        return;
+
+    //old matches are dropped on next scan
+    m_dirty.insert(std::upper_bound(m_dirty.begin(), m_dirty.end(), line), line);
+}
+
+void MatchIndex::AddLine(size_t line)
+{
+    if (line >= m_scanLine)
+        return;
+
+    //lines added one after another are shifted together later
+    if (m_shift < 0 || line < m_shiftLine || line > m_shiftLine + m_shift)
+    {
+        ApplyShift();
+        m_shiftLine = line;
+    }
+    ++m_shift;
+
+    ShiftDirty(line, true);
+    ++m_scanLine;
+    m_dirty.insert(std::upper_bound(m_dirty.begin(), m_dirty.end(), line), line);
+}
+
+void MatchIndex::DelLine(size_t line)
+{
+    if (line >= m_scanLine)
+        return;
+
+    //lines deleted one after another are removed together later
+    if (m_shift > 0 && line >= m_shiftLine && line < m_shiftLine + m_shift)
+        //added line without matches
+        --m_shift;
+    else
+    {
+        if (line != m_shiftLine + m_shift)
+        {
+            ApplyShift();
+            m_shiftLine = line;
+        }
+        else if (m_shift > 0)
+            EraseLine(m_shiftLine);
+        ++m_shiftLine;
+        --m_shift;
+    }
+
+    if (auto it = std::lower_bound(m_dirty.begin(), m_dirty.end(), line); it != m_dirty.end() && *it == line)
+        m_dirty.erase(it);
+    ShiftDirty(line + 1, false);
+    --m_scanLine;
+}
+
+bool MatchIndex::ScanDirty()
+{
+    ApplyShift();
+    if (m_dirty.empty())
+        return false;
+
+    //rebuild in one pass, it is fast for many changed lines
+    std::vector<Match> match;
+    match.reserve(m_match.size());
+
+    auto it = m_match.cbegin();
+    line_match_t found;
+    for (auto line : m_dirty)
+    {
+        auto lineIt = std::lower_bound(it, m_match.cend(), line,
+            [](const Match& m, size_t l) { return m.line < l; });
+        match.insert(match.end(), it, lineIt);
+        it = std::find_if(lineIt, m_match.cend(), [line](const Match& m) { return m.line != line; });
+
+        found.clear();
+        m_func(line, found);
+        for (auto [x, size] : found)
+            match.push_back({ line, x, size });
+    }
+    match.insert(match.end(), it, m_match.cend());
+
+    m_match.swap(match);
+    m_dirty.clear();
+    return true;
+}
+
+void MatchIndex::ScanLine(size_t line)
+{
+    if (line < m_scanLine)
+        return;
+
+    //index is only appended here
+    m_scanLine = line;
+    InsertLine(line);
+    ++m_scanLine;
+}
+
+std::optional<size_t> MatchIndex::GetNumber(size_t line, size_t x) const
+{
+    auto it = std::lower_bound(m_match.cbegin(), m_match.cend(), std::make_pair(line, x),
+        [](const Match& match, const std::pair<size_t, size_t>& pos) { return std::make_pair(match.line, match.x) < pos; });
+    if (it == m_match.cend() || it->line != line || it->x != x)
+        return std::nullopt;
+    return std::distance(m_match.cbegin(), it);
+}
+
+std::optional<MatchIndex::Match> MatchIndex::FindDown(size_t line, size_t x, size_t end) const
+{
+    auto it = std::lower_bound(m_match.cbegin(), m_match.cend(), std::make_pair(line, x),
+        [](const Match& match, const std::pair<size_t, size_t>& pos) { return std::make_pair(match.line, match.x) < pos; });
+    if (it == m_match.cend() || it->line >= end)
+        return std::nullopt;
+    return *it;
+}
+
+std::optional<MatchIndex::Match> MatchIndex::FindUp(size_t line, size_t x, size_t end, bool inside) const
+{
+    auto it = LineBegin(line + 1);
+    while (it != m_match.cbegin())
+    {
+        --it;
+        if (it->line < end)
+            break;
+        if (it->line < line || (inside ? it->x + it->size <= x : it->x < x))
+            return *it;
+    }
+    return std::nullopt;
+}
+
+std::vector<MatchIndex::Match> MatchIndex::GetMatches(size_t line, size_t x, size_t end) const
+{
+    auto it = std::lower_bound(m_match.cbegin(), m_match.cend(), std::make_pair(line, x),
+        [](const Match& match, const std::pair<size_t, size_t>& pos) { return std::make_pair(match.line, match.x) < pos; });
+    auto itEnd = LineBegin(end);
+    if (it >= itEnd)
+        return {};
+    return { it, itEnd };
+}
+
+line_match_t MatchIndex::GetLine(size_t line) const
+{
+    line_match_t found;
+    for (auto it = LineBegin(line); it != m_match.cend() && it->line == line; ++it)
+        found.emplace_back(it->x, it->size);
+    return found;
+}
+
+} //namespace _Editor
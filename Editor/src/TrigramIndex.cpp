@@ -0,0 +1,514 @@
+/*
+FreeBSD License
+
+Copyright (c) 2020-2021 vikonix: valeriy.kovalev.software@gmail.com
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "TrigramIndex.h"
+#include "Editor.h"
+#include "utils/logger.h"
+#include "utils/CpConverter.h"
+#include "Version.h"
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <sstream>
+
+
+namespace _Editor
+{
+
+static void PutVarint(std::string& buff, uint64_t val)
+{
+    while (val >= 0x80)
+    {
+        buff += static_cast<char>(val | 0x80);
+        val >>= 7;
+    }
+    buff += static_cast<char>(val);
+}
+
+static bool GetVarint(const std::string& buff, size_t& pos, uint64_t& val)
+{
+    val = 0;
+    for (size_t shift = 0; pos < buff.size() && shift < 64; shift += 7)
+    {
+        auto c = static_cast<uint8_t>(buff[pos++]);
+        val |= static_cast<uint64_t>(c & 0x7f) << shift;
+        if (c < 0x80)
+            return true;
+    }
+    return false;
+}
+
+static void PutStr(std::string& buff, const std::string& str)
+{
+    PutVarint(buff, str.size());
+    buff += str;
+}
+
+static bool GetStr(const std::string& buff, size_t& pos, std::string& str)
+{
+    uint64_t size;
+    if (!GetVarint(buff, pos, size) || size > buff.size() - pos)
+        return false;
+    str = buff.substr(pos, static_cast<size_t>(size));
+    pos += static_cast<size_t>(size);
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+TrigramIndex::TrigramIndex(const path_t& root)
+{
+    std::error_code ec;
+    m_root = std::filesystem::canonical(root, ec);
+    if (ec)
+        m_root = std::filesystem::absolute(root, ec).lexically_normal();
+
+    std::stringstream name;
+    name << std::hex << std::hash<std::string>{}(m_root.u8string()) << c_indexExt;
+    m_indexPath = Directory::UserLocalPath(EDITOR_NAME, true) / c_indexDir / name.str();
+}
+
+bool TrigramIndex::IsCovered(const path_t& path) const
+{
+    auto rel = path.lexically_normal().lexically_relative(m_root);
+    return !rel.empty() && *rel.begin() != "..";
+}
+
+uint32_t TrigramIndex::GetTrigram(uint8_t c1, uint8_t c2, uint8_t c3)
+{
+    //latin symbols are in lower case
+    auto lower = [](uint8_t c) -> uint32_t { return c >= 'A' && c <= 'Z' ? c + 'a' - 'A' : c; };
+    return lower(c1) << 16 | lower(c2) << 8 | lower(c3);
+}
+
+int64_t TrigramIndex::GetFileTime(const path_t& file, std::error_code& ec)
+{
+    return static_cast<int64_t>(std::filesystem::last_write_time(file, ec).time_since_epoch().count());
+}
+
+void TrigramIndex::Update()
+{
+    if (m_updating)
+        return;
+
+    if (m_thread.joinable())
+        m_thread.join();
+
+    m_cancel = false;
+    m_updating = true;
+    m_thread = std::thread(&TrigramIndex::UpdateIndex, this);
+}
+
+void TrigramIndex::Stop()
+{
+    m_cancel = true;
+    if (m_thread.joinable())
+        m_thread.join();
+}
+
+void TrigramIndex::Clear()
+{
+    m_files.clear();
+    m_fileMap.clear();
+    m_postings.clear();
+    m_removed = 0;
+}
+
+bool TrigramIndex::Load()
+{
+    std::ifstream ifs{ m_indexPath, std::ios::binary };
+    if (!ifs)
+        return false;
+
+    std::string buff{ std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>() };
+
+    std::unique_lock lock{ m_mutex };
+    Clear();
+
+    size_t pos{};
+    uint64_t val;
+    std::string str;
+    bool rc = GetVarint(buff, pos, val) && val == c_magic
+        && GetStr(buff, pos, str) && str == m_root.u8string()
+        && GetVarint(buff, pos, val);
+
+    for (uint64_t n = val; rc && n; --n)
+    {
+        FileInfo info;
+        uint64_t size, time, flags;
+        rc = GetStr(buff, pos, info.path) && GetVarint(buff, pos, size)
+            && GetVarint(buff, pos, time) && GetVarint(buff, pos, flags);
+        if (!rc)
+            break;
+
+        info.size = static_cast<uintmax_t>(size);
+        info.time = static_cast<int64_t>(time);
+        info.indexed = (flags & 1) != 0;
+        info.removed = (flags & 2) != 0;
+        if (info.removed)
+            ++m_removed;
+        else
+            m_fileMap[info.path] = static_cast<uint32_t>(m_files.size());
+        m_files.push_back(std::move(info));
+    }
+
+    rc = rc && GetVarint(buff, pos, val);
+    for (uint64_t n = val; rc && n; --n)
+    {
+        uint64_t trigram, last;
+        Posting posting;
+        rc = GetVarint(buff, pos, trigram) && GetVarint(buff, pos, last) && GetStr(buff, pos, posting.data);
+        posting.last = static_cast<uint32_t>(last);
+        if (rc)
+            m_postings.emplace(static_cast<uint32_t>(trigram), std::move(posting));
+    }
+
+    if (!rc)
+    {
+        LOG(ERROR) << "wrong index file=" << m_indexPath.u8string();
+        Clear();
+    }
+    return rc;
+}
+
+bool TrigramIndex::Save()
+{
+    std::string buff;
+    {
+        std::unique_lock lock{ m_mutex };
+        PutVarint(buff, c_magic);
+        PutStr(buff, m_root.u8string());
+
+        PutVarint(buff, m_files.size());
+        for (auto& info : m_files)
+        {
+            PutStr(buff, info.path);
+            PutVarint(buff, info.size);
+            PutVarint(buff, static_cast<uint64_t>(info.time));
+            PutVarint(buff, (info.indexed ? 1 : 0) | (info.removed ? 2 : 0));
+        }
+
+        PutVarint(buff, m_postings.size());
+        for (auto& [trigram, posting] : m_postings)
+        {
+            PutVarint(buff, trigram);
+            PutVarint(buff, posting.last);
+            PutStr(buff, posting.data);
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(m_indexPath.parent_path(), ec);
+
+    path_t tmpPath{ m_indexPath };
+    tmpPath += "~";
+    std::ofstream ofs{ tmpPath, std::ios::binary | std::ios::trunc };
+    ofs.write(buff.data(), buff.size());
+    ofs.close();
+    if (!ofs)
+    {
+        LOG(ERROR) << "index write error file=" << tmpPath.u8string();
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+
+    std::filesystem::rename(tmpPath, m_indexPath, ec);
+    return !ec;
+}
+
+bool TrigramIndex::ScanFile(const path_t& file, ScanBuff& buff, std::vector<uint32_t>& trigrams)
+{
+    trigrams.clear();
+
+    std::ifstream fileStream{ file, std::ios::binary };
+    if (!fileStream)
+        return false;
+
+    if (buff.buff.size() != c_scanBuffSize)
+        buff.buff.resize(c_scanBuffSize);
+
+    auto unique = [&trigrams]() {
+        std::sort(trigrams.begin(), trigrams.end());
+        trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+    };
+
+    uint8_t c1{}, c2{};
+    size_t count{};
+    while (!m_cancel)
+    {
+        fileStream.read(buff.buff.data(), buff.buff.size());
+        auto read = static_cast<size_t>(fileStream.gcount());
+        for (size_t i = 0; i < read; ++i)
+        {
+            auto c = static_cast<uint8_t>(buff.buff[i]);
+            if (++count >= 3)
+                trigrams.push_back(GetTrigram(c1, c2, c));
+            c1 = c2;
+            c2 = c;
+        }
+
+        if (trigrams.size() > c_maxTrigrams)
+            unique();
+        if (fileStream.eof() || read == 0)
+            break;
+    }
+
+    unique();
+    return !m_cancel;
+}
+
+void TrigramIndex::AddFile(FileInfo&& info, const std::vector<uint32_t>& trigrams)
+{
+    std::unique_lock lock{ m_mutex };
+    auto id = static_cast<uint32_t>(m_files.size());
+
+    auto it = m_fileMap.find(info.path);
+    if (it != m_fileMap.end())
+    {
+        m_files[it->second].removed = true;
+        ++m_removed;
+        it->second = id;
+    }
+    else
+        m_fileMap.emplace(info.path, id);
+
+    if (info.indexed)
+        for (auto trigram : trigrams)
+        {
+            auto& posting = m_postings[trigram];
+            PutVarint(posting.data, posting.data.empty() ? id : id - posting.last);
+            posting.last = id;
+        }
+
+    m_files.push_back(std::move(info));
+}
+
+std::vector<uint32_t> TrigramIndex::GetPosting(uint32_t trigram)
+{
+    std::vector<uint32_t> ids;
+    auto it = m_postings.find(trigram);
+    if (it == m_postings.end())
+        return ids;
+
+    auto& data = it->second.data;
+    uint32_t id{};
+    uint64_t delta;
+    for (size_t pos = 0; pos < data.size() && GetVarint(data, pos, delta);)
+    {
+        id += static_cast<uint32_t>(delta);
+        ids.push_back(id);
+    }
+    return ids;
+}
+
+void TrigramIndex::UpdateIndex()
+{
+    LOG(DEBUG) << "update index root=" << m_root.u8string();
+    try
+    {
+        if (!m_loaded)
+        {
+            [[maybe_unused]] bool rc = Load();
+            m_loaded = true;
+        }
+
+        std::vector<bool> seen;
+        {
+            //too many removed files, it is time to rebuild
+            std::unique_lock lock{ m_mutex };
+            if (m_removed * 2 > m_files.size())
+                Clear();
+            seen.resize(m_files.size());
+        }
+
+        ScanBuff buff;
+        std::vector<uint32_t> trigrams;
+        bool changed{};
+
+        std::error_code ec;
+        auto options = std::filesystem::directory_options::skip_permission_denied;
+        for (std::filesystem::recursive_directory_iterator it{ m_root, options, ec }, end; !m_cancel && !ec && it != end; it.increment(ec))
+        {
+            auto& entry = *it;
+            auto name = entry.path().filename().u8string();
+            if (entry.is_directory(ec))
+            {
+                //hidden directories as .git are not indexed
+                if (!name.empty() && name[0] == '.')
+                    it.disable_recursion_pending();
+                continue;
+            }
+            if (!entry.is_regular_file(ec))
+                continue;
+
+            FileInfo info{ entry.path().lexically_normal().u8string() };
+            info.size = entry.file_size(ec);
+            info.time = GetFileTime(entry.path(), ec);
+            if (ec)
+            {
+                ec.clear();
+                continue;
+            }
+
+            {
+                std::unique_lock lock{ m_mutex };
+                auto found = m_fileMap.find(info.path);
+                if (found != m_fileMap.end() && m_files[found->second].size == info.size && m_files[found->second].time == info.time)
+                {
+                    seen[found->second] = true;
+                    continue;
+                }
+            }
+
+            info.indexed = info.size <= c_maxFileSize && ScanFile(entry.path(), buff, trigrams);
+            AddFile(std::move(info), trigrams);
+            seen.push_back(true);
+            changed = true;
+        }
+
+        if (!m_cancel)
+        {
+            std::unique_lock lock{ m_mutex };
+            for (size_t id = 0; id < seen.size(); ++id)
+            {
+                auto& info = m_files[id];
+                if (!seen[id] && !info.removed)
+                {
+                    info.removed = true;
+                    ++m_removed;
+                    m_fileMap.erase(info.path);
+                    changed = true;
+                }
+            }
+        }
+
+        if (changed)
+            Save();
+    }
+    catch (const std::exception& ex)
+    {
+        LOG(ERROR) << __FUNC__ << " exception: " << ex.what();
+    }
+
+    LOG(DEBUG) << "index updated root=" << m_root.u8string();
+    m_updating = false;
+}
+
+FileSearcher::filter_func TrigramIndex::GetFilter(const std::u16string& toFind, const std::string& cp, bool checkCase)
+{
+    //the string is checked in file code page
+    std::string str;
+    try
+    {
+        iconvpp::CpConverter converter{ cp };
+        if (!converter.Convert(toFind, str))
+            return nullptr;
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+
+    //case of not latin symbols is unknown here,
+    //latin letter can also be found as not latin case variant ('s' as U+017F),
+    //'?' can be in place of wrong symbol in file
+    //variants depend on locale, so they are not kept
+    std::array<bool, 0x80> otherCase{};
+    for (char16_t c = 0; c < 0x80; ++c)
+    {
+        auto variants = Editor::GetCaseVariants(c);
+        otherCase[c] = std::any_of(variants.cbegin(), variants.cend(), [](char16_t v) { return v >= 0x80; });
+    }
+
+    std::vector<uint32_t> query;
+    for (size_t i = 2; i < str.size(); ++i)
+    {
+        std::string_view tri{ str.data() + i - 2, 3 };
+        if (tri.find('?') != std::string_view::npos
+            || (!checkCase && std::any_of(tri.cbegin(), tri.cend(), [&otherCase](char c) {
+                return static_cast<uint8_t>(c) >= 0x80 || otherCase[static_cast<uint8_t>(c)]; })))
+            continue;
+        query.push_back(GetTrigram(tri[0], tri[1], tri[2]));
+    }
+    std::sort(query.begin(), query.end());
+    query.erase(std::unique(query.begin(), query.end()), query.end());
+    if (query.empty())
+        return nullptr;
+
+    using excluded_t = std::unordered_map<std::string, std::pair<uintmax_t, int64_t>>;
+    auto excluded = std::make_shared<excluded_t>();
+    {
+        std::unique_lock lock{ m_mutex };
+        if (m_fileMap.empty())
+            return nullptr;
+
+        //the shortest lists first
+        std::sort(query.begin(), query.end(), [this](uint32_t t1, uint32_t t2) {
+            auto p1 = m_postings.find(t1);
+            auto p2 = m_postings.find(t2);
+            return (p1 == m_postings.end() ? 0 : p1->second.data.size()) < (p2 == m_postings.end() ? 0 : p2->second.data.size());
+        });
+
+        std::vector<uint32_t> ids;
+        for (size_t i = 0; i < query.size(); ++i)
+        {
+            auto posting = GetPosting(query[i]);
+            if (i == 0)
+                ids = std::move(posting);
+            else
+            {
+                std::vector<uint32_t> both;
+                std::set_intersection(ids.cbegin(), ids.cend(), posting.cbegin(), posting.cend(), std::back_inserter(both));
+                ids = std::move(both);
+            }
+            if (ids.empty())
+                break;
+        }
+
+        for (uint32_t id = 0; id < m_files.size(); ++id)
+        {
+            auto& info = m_files[id];
+            if (info.indexed && !info.removed && !std::binary_search(ids.cbegin(), ids.cend(), id))
+                excluded->emplace(info.path, std::make_pair(info.size, info.time));
+        }
+    }
+
+    LOG(DEBUG) << "index excluded " << excluded->size() << " file(s)";
+
+    //file changed after indexing is scanned
+    return [excluded](const path_t& file) {
+        auto it = excluded->find(file.lexically_normal().u8string());
+        if (it == excluded->end())
+            return true;
+
+        std::error_code ec;
+        auto size = std::filesystem::file_size(file, ec);
+        auto time = GetFileTime(file, ec);
+        return ec || size != it->second.first || time != it->second.second;
+    };
+}
+
+} //namespace _Editor
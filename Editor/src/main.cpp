@@ -33,11 +33,14 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "utfcpp/utf8.h"
 #include "cxxopts/cxxopts.hpp"
 #include "EditorApp.h"
+#include "FileReplacer.h"
 #include "Version.h"
 #include "Config.h"
 
 
+#include <clocale>
 #include <filesystem>
+#include <thread>
 
 using namespace _Editor;
 
@@ -93,6 +96,113 @@ void SaveConfig()
     auto localPath = Directory::UserLocalPath(EDITOR_NAME, true);
 }
 
+int BatchReplace(const cxxopts::ParseResult& result)
+{
+    //case of not latin symbols depends on locale as in editor
+    std::setlocale(LC_CTYPE, "");
+
+    auto toFind = utf8::utf8to16(result["find"].as<std::string>());
+    auto replace = result.count("replace") ? utf8::utf8to16(result["replace"].as<std::string>()) : std::u16string{};
+    auto cp = result["encoding"].as<std::string>();
+    bool regex = result.count("regex") != 0;
+    bool dryRun = result.count("dry-run") != 0;
+    auto& paths = result.unmatched();
+
+    //one replacer for all paths, so file given twice is replaced once
+    FileReplacer replacer(toFind, replace, cp, result.count("case") != 0, result.count("word") != 0, regex);
+    if (!replacer.IsValid())
+    {
+        std::cerr << (regex ? "Regular expression: " : "") << replacer.GetError() << std::endl;
+        return 1;
+    }
+    replacer.SetBinary(result.count("binary") != 0);
+    replacer.SetDryRun(dryRun);
+
+    size_t files{};
+    size_t scanned{};
+    for (auto& p : paths)
+    {
+        std::filesystem::path path = std::filesystem::absolute(utf8::utf8to16(p));
+        std::string mask = result["mask"].as<std::string>();
+        bool recursive = result.count("subdir") != 0;
+        if (std::filesystem::is_regular_file(path))
+        {
+            mask = path.filename().u8string();
+            path = path.parent_path();
+            recursive = false;
+        }
+
+        replacer.Start(path / utf8::utf8to16(mask), mask, recursive);
+        std::vector<FileSearcher::found_t> found;
+        for (bool done{}; !done;)
+        {
+            done = replacer.IsDone();
+            if (!done)
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            auto part = replacer.GetFound();
+            std::move(part.begin(), part.end(), std::back_inserter(found));
+        }
+
+        std::sort(found.begin(), found.end(), [](const auto& f1, const auto& f2) { return std::get<0>(f1) < std::get<0>(f2); });
+        for (auto& [file, count, matches] : found)
+            std::cout << file.u8string() << ": " << count << std::endl;
+
+        files += found.size();
+        scanned += replacer.GetScanned();
+    }
+
+    auto failedFiles = replacer.GetFailed();
+    for (auto& file : failedFiles)
+        std::cerr << file.u8string() << ": not written" << std::endl;
+    size_t replaced{ replacer.GetReplaced() };
+    size_t failed{ failedFiles.size() };
+
+    std::cout << (dryRun ? "Found " : "Replaced ") << replaced << " match(es) in " << files << " of " << scanned << " file(s)";
+    if (failed)
+        std::cout << ", " << failed << " file(s) not written";
+    std::cout << std::endl;
+
+    return failed ? 1 : 0;
+}
+
+//editing scenario replayed without terminal
+void AddBenchSteps()
+{
+    auto& wndManager = WndManager::getInstance();
+    auto repeat = [](size_t n, std::initializer_list<input_t> keys) {
+        keybuff_t buff;
+        for (size_t i = 0; i < n; ++i)
+            buff.insert(buff.end(), keys);
+        return buff;
+    };
+
+    keybuff_t type;
+    for (char c : std::string{"benchmark typed text; "})
+        type.push_back(static_cast<input_t>(c));
+
+    wndManager.AddScriptStep("open", {});
+    wndManager.AddScriptStep("page down", repeat(20, {K_PAGEDN}));
+    wndManager.AddScriptStep("line down", repeat(100, {K_DOWN}));
+    wndManager.AddScriptStep("line up", repeat(100, {K_UP}));
+    wndManager.AddScriptStep("page up", repeat(20, {K_PAGEUP}));
+    wndManager.AddScriptStep("find word", repeat(20, {K_F7 | K_CTRL}));
+    wndManager.AddScriptStep("right", repeat(100, {K_RIGHT}));
+    wndManager.AddScriptStep("type", type);
+    wndManager.AddScriptStep("undo", repeat(type.size(), {K_BS | K_ALT}));
+    wndManager.AddScriptStep("new line", repeat(20, {K_ENTER}));
+    wndManager.AddScriptStep("file end", {K_END | K_CTRL});
+}
+
+void PrintBench(const std::vector<HeadlessStep>& steps)
+{
+    std::cout << std::left << std::setw(12) << "step" << std::right
+        << std::setw(10) << "bytes" << std::setw(8) << "flushes" << std::setw(8) << "frames" << std::setw(10) << "time,us" << std::endl;
+    for (auto& step : steps)
+        std::cout << std::left << std::setw(12) << step.name << std::right
+            << std::setw(10) << step.bytes << std::setw(8) << step.flushes << std::setw(8) << step.frames
+            << std::setw(10) << step.time.count() << std::endl;
+}
+
 /////////////////////////////////////////////////////////////////////////////
 int main(int argc, char** argv) try
 {
@@ -108,7 +218,21 @@ int main(int argc, char** argv) try
         ("h,help", "Print usage")
         ("k,keys", "Print key map combinations")
         ("c,config", "Save default config files")
+        ("bench", "Replay editing scenario with file without terminal and print output statistics")
+        ;
+    options.add_options("Replace in files without editor")
+        ("f,find", "String to find", cxxopts::value<std::string>())
+        ("r,replace", "String to replace with, it can be empty", cxxopts::value<std::string>())
+        ("n,dry-run", "List matches without writing files")
+        ("x,regex", "Find string is regular expression")
+        ("case", "Case sensitive search")
+        ("w,word", "Whole word search")
+        ("s,subdir", "Replace in sub-directories")
+        ("binary", "Replace in binary files with zero bytes too")
+        ("m,mask", "File mask", cxxopts::value<std::string>()->default_value("*.*"))
+        ("e,encoding", "Files encoding", cxxopts::value<std::string>()->default_value("UTF-8"))
         ;
+    options.custom_help("[OPTION...] [files | paths for replace]");
 
     auto result = options.parse(argc, argv);
     if (result.count("help"))
@@ -126,6 +250,33 @@ int main(int argc, char** argv) try
         SaveConfig();
         return 0;
     }
+    else if (result.count("find"))
+    {
+        //files are changed only with explicit replace string and paths
+        if ((!result.count("replace") && !result.count("dry-run")) || result.unmatched().empty())
+        {
+            std::cerr << (result.unmatched().empty() ? "Files for replace are not set" : "String to replace is not set") << std::endl;
+            std::cerr << options.help() << std::endl;
+            return 1;
+        }
+        return BatchReplace(result);
+    }
+
+    bool bench = result.count("bench") != 0;
+    if (bench)
+    {
+        if (result.unmatched().empty())
+        {
+            std::cerr << "File for benchmark is not set" << std::endl;
+            return 1;
+        }
+        if (!WndManager::getInstance().SetHeadless(100, 40))
+        {
+            std::cerr << "Benchmark is not supported" << std::endl;
+            return 1;
+        }
+        AddBenchSteps();
+    }
 
     app.Init();
     app.WriteAppName(EDITOR_NAME);
@@ -152,8 +303,14 @@ int main(int argc, char** argv) try
         _TRY(app.LoadSession(std::nullopt));
 
     app.MainProc(K_EXIT);
+    std::vector<HeadlessStep> steps;
+    if (bench)
+        steps = WndManager::getInstance().GetScriptReport();
     app.Deinit();
 
+    if (bench)
+        PrintBench(steps);
+
     LOG(INFO) << "Exit";
     return 0;
 }
@@ -0,0 +1,214 @@
+/*
+FreeBSD License
+
+Copyright (c) 2020-2021 vikonix: valeriy.kovalev.software@gmail.com
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#ifdef USE_VLD
+  #include <vld.h>
+#endif
+
+#include "utils/logger.h"
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+/////////////////////////////////////////////////////////////////////////////
+using namespace _Utils;
+
+namespace fs = std::filesystem;
+
+//editor is run with command line for replace in files
+static fs::path s_editor;
+static fs::path s_dir;
+
+void WriteFile(const fs::path& path, const std::string& data)
+{
+    std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+    file << data;
+}
+
+std::string ReadFile(const fs::path& path)
+{
+    std::ifstream file{ path, std::ios::binary };
+    std::stringstream data;
+    data << file.rdbuf();
+    return data.str();
+}
+
+//editor output is saved in out.txt
+int Run(const std::string& args)
+{
+    std::string cmd{ "\"" + s_editor.u8string() + "\" " + args + " > \"" + (s_dir / "out.txt").u8string() + "\" 2>&1" };
+#ifdef WIN32
+    cmd = "\"" + cmd + "\"";
+#endif
+    int rc = std::system(cmd.c_str());
+    LOG(INFO) << cmd << " rc=" << rc << "\n" << ReadFile(s_dir / "out.txt");
+    return rc;
+}
+
+std::string Quote(const fs::path& path)
+{
+    return "\"" + path.u8string() + "\"";
+}
+
+void FindOnlyTest()
+{
+    fs::path dir{ s_dir / "find" };
+    fs::create_directories(dir / "sub");
+    WriteFile(dir / "a.txt", "foo\nFOO\n");
+    WriteFile(dir / "Makefile", "foo\n");
+    WriteFile(dir / "sub" / "b.txt", "foo foo\n");
+
+    //nothing is replaced without replace string or paths
+    auto cur = fs::current_path();
+    fs::current_path(dir);
+    _assert(Run("-f foo") != 0);
+    _assert(Run("-f foo -s") != 0);
+    _assert(Run("-f foo -r bar") != 0);
+    _assert(Run("-f foo -s .") != 0);
+    _assert(Run("-f foo -s -x -r bar") != 0);
+
+    //dry run only counts matches
+    _assert(Run("-f foo -n -s .") == 0);
+    _assert(ReadFile(s_dir / "out.txt").find("Found 5 match(es) in 3 of 3 file(s)") != std::string::npos);
+    _assert(Run("-f foo -r bar -n -s .") == 0);
+    fs::current_path(cur);
+
+    _assert(ReadFile(dir / "a.txt") == "foo\nFOO\n");
+    _assert(ReadFile(dir / "Makefile") == "foo\n");
+    _assert(ReadFile(dir / "sub" / "b.txt") == "foo foo\n");
+
+    //empty replace string is given explicitly
+    _assert(Run("-f foo -r \"\" " + Quote(dir / "a.txt")) == 0);
+    _assert(ReadFile(dir / "a.txt") == "\n\n");
+    _assert(ReadFile(dir / "Makefile") == "foo\n");
+
+    //plain string error is not regular expression one
+    _assert(Run("-f \"\" -r bar " + Quote(dir)) != 0);
+    _assert(ReadFile(s_dir / "out.txt").find("Regular expression") == std::string::npos);
+    _assert(Run("-f \"(\" -x -r bar " + Quote(dir)) != 0);
+    _assert(ReadFile(s_dir / "out.txt").find("Regular expression") != std::string::npos);
+}
+
+void EolTest()
+{
+    fs::path dir{ s_dir / "eol" };
+    fs::create_directories(dir);
+
+    //BOM and line ends are kept, only changed lines are written again
+    const std::string bom{ "\xef\xbb\xbf" };
+    WriteFile(dir / "crlf.txt", bom + "Foo\r\nbar foo\r\n\r\nfoo");
+    WriteFile(dir / "mixed.txt", "foo\nbar\r\nfOO\rend\r\n");
+    WriteFile(dir / "none.txt", bom + "bar\r\n");
+
+    _assert(Run("-f foo -r x " + Quote(dir)) == 0);
+    _assert(ReadFile(dir / "crlf.txt") == bom + "x\r\nbar x\r\n\r\nx");
+    _assert(ReadFile(dir / "mixed.txt") == "x\nbar\r\nx\rend\r\n");
+    _assert(ReadFile(dir / "none.txt") == bom + "bar\r\n");
+
+    _assert(Run("-f x -r foo --case " + Quote(dir / "crlf.txt")) == 0);
+    _assert(ReadFile(dir / "crlf.txt") == bom + "foo\r\nbar foo\r\n\r\nfoo");
+    _assert(ReadFile(dir / "mixed.txt") == "x\nbar\r\nx\rend\r\n");
+}
+
+void CaseTest()
+{
+    fs::path dir{ s_dir / "case" };
+    fs::create_directories(dir);
+
+    //all symbols with the same upper case are found, final sigma and micro sign too
+    WriteFile(dir / "sigma.txt", "ΣΟΦΟΣ σοφός\n");
+    WriteFile(dir / "mu.txt", "μ µ Μ m\n");
+    _assert(Run("-f σ -r _ " + Quote(dir / "sigma.txt")) == 0);
+    _assert(ReadFile(dir / "sigma.txt") == "_ΟΦΟ_ _οφό_\n");
+    _assert(Run("-f µ -r _ " + Quote(dir / "mu.txt")) == 0);
+    _assert(ReadFile(dir / "mu.txt") == "_ _ _ m\n");
+
+    WriteFile(dir / "sigma.txt", "σοφός\n");
+    _assert(Run("-f ΟΣ -r os " + Quote(dir / "sigma.txt")) == 0);
+    _assert(ReadFile(dir / "sigma.txt") == "σοφός\n");
+    _assert(Run("-f ός -r os " + Quote(dir / "sigma.txt")) == 0);
+    _assert(ReadFile(dir / "sigma.txt") == "σοφos\n");
+    _assert(Run("-f ΣΟΦ -r x " + Quote(dir / "sigma.txt")) == 0);
+    _assert(ReadFile(dir / "sigma.txt") == "xos\n");
+}
+
+#ifndef WIN32
+void LinkTest()
+{
+    fs::path dir{ s_dir / "link" };
+    fs::create_directories(dir / "sub");
+    WriteFile(dir / "a.txt", "foo\nfoo\nfoo\nfoo\n");
+    fs::create_symlink("a.txt", dir / "link.txt");
+    fs::create_symlink("../a.txt", dir / "sub" / "b.txt");
+    //link to parent makes loop
+    fs::create_symlink(dir, dir / "sub" / "loop");
+
+    //real file is replaced once
+    _assert(Run("-f foo -r foofoo -s " + Quote(dir) + " " + Quote(dir / "link.txt")) == 0);
+    _assert(ReadFile(s_dir / "out.txt").find("Replaced 4 match(es)") != std::string::npos);
+    _assert(ReadFile(dir / "a.txt") == "foofoo\nfoofoo\nfoofoo\nfoofoo\n");
+    _assert(fs::is_symlink(dir / "link.txt"));
+    _assert(fs::is_symlink(dir / "sub" / "b.txt"));
+
+    for (auto& entry : fs::directory_iterator(dir))
+        _assert(entry.path().extension() != ".replace~");
+}
+#endif
+
+int main([[maybe_unused]] int argc, char* argv[])
+{
+    ConfigureLogger("m-%datetime{%Y%M%d}.log", 0x200000, false);
+    LOG(INFO);
+    LOG(INFO) << "Editor test";
+    std::cout << "Editor test starts..." << std::endl;
+
+#ifdef WIN32
+    s_editor = fs::absolute(argv[0]).parent_path() / "multitextor.exe";
+#else
+    s_editor = fs::absolute(argv[0]).parent_path() / "multitextor";
+    //case of not latin symbols depends on locale
+    setenv("LC_ALL", "C.UTF-8", 1);
+#endif
+    s_dir = fs::temp_directory_path() / "TestEditor";
+    fs::remove_all(s_dir);
+    fs::create_directories(s_dir);
+
+    FindOnlyTest();
+    EolTest();
+    CaseTest();
+#ifndef WIN32
+    LinkTest();
+#endif
+
+    fs::remove_all(s_dir);
+    std::cout << "Editor test finished" << std::endl;
+    LOG(INFO) << "End";
+
+    return 0;
+}
@@ -52,6 +52,7 @@ public:
 
     bool Convert(std::string_view str, std::u16string& out);
     bool Convert(char16_t ch, std::string& out);
+    bool Convert(std::u16string_view str, std::string& out);
 
     static std::list<std::string> GetCpList();
 
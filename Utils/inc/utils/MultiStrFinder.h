@@ -0,0 +1,88 @@
+/*
+FreeBSD License
+
+Copyright (c) 2020-2021 vikonix: valeriy.kovalev.software@gmail.com
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace _Utils
+{
+
+//////////////////////////////////////////////////////////////////////////////
+//Find any of several strings in raw data (Aho-Corasick automaton).
+//Every symbol of string is a list of encoded variants as in StrFinder.
+//Bytes are mapped to classes, so the transition table has only columns for bytes used in strings.
+class MultiStrFinder
+{
+public:
+    inline static const size_t npos{ std::string::npos };
+
+    struct Match
+    {
+        size_t  pos;
+        size_t  size;
+        size_t  id;
+    };
+
+private:
+    inline static const size_t      c_maxVariants{ 1024 };
+    inline static const uint32_t    c_none{ UINT32_MAX };
+
+    bool                                        m_foldCase{};   //ASCII letters are compared without case
+    std::vector<std::pair<std::string, size_t>> m_strings;      //all variants of strings with id
+
+    std::array<uint8_t, 256>    m_class{};
+    size_t                      m_classCount{};
+    std::vector<uint32_t>       m_next;     //[state * m_classCount + class]
+    std::vector<uint32_t>       m_out;      //the longest string ending in state
+    std::vector<uint32_t>       m_dict;     //the next state with output by fail links
+    size_t                      m_stateCount{};
+
+    uint8_t Fold(uint8_t c) const
+    {
+        return m_foldCase && c >= 'A' && c <= 'Z' ? c + 0x20 : c;
+    }
+
+public:
+    explicit MultiStrFinder(bool foldCase = false) : m_foldCase{ foldCase } {}
+
+    //false if it gives too many variants
+    bool    AddString(const std::vector<std::vector<std::string>>& symbols, size_t id);
+    bool    AddString(const std::string& str, size_t id) { return AddString(std::vector<std::vector<std::string>>{ {str} }, id); }
+    bool    Build();
+    bool    Empty() const {return m_stateCount == 0;}
+
+    //position of the first string ended in data beginning from 'from'
+    size_t  Find(std::string_view data, size_t from = 0) const;
+    //all strings in data, the leftmost and the longest first, without overlapping
+    void    FindAll(std::string_view data, std::vector<Match>& found) const;
+};
+
+} //namespace _Utils
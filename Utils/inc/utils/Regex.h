@@ -0,0 +1,204 @@
+/*
+FreeBSD License
+
+Copyright (c) 2020-2021 vikonix: valeriy.kovalev.software@gmail.com
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <bitset>
+#include <array>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace _Utils
+{
+
+//groups positions in bytes [begin, end), group 0 is the whole match
+using match_t = std::vector<std::pair<size_t, size_t>>;
+
+//////////////////////////////////////////////////////////////////////////////
+//Regular expression with linear time matching.
+//Pattern is compiled to byte level Thompson NFA.
+//Search() checks a string with lazy built DFA, Match() runs Pike VM and returns groups.
+//Syntax: . [] [^] () (?:) | * + ? {n} {n,} {n,m} *? +? ?? ^ $ \d \w \s \D \W \S \t \xHH
+class Regex
+{
+public:
+    inline static const size_t npos{ std::string::npos };
+    inline static const size_t c_maxGroups{ 10 };
+
+private:
+    inline static const size_t c_maxInst{ 0x8000 };
+    inline static const size_t c_maxRepeat{ 1000 };
+    inline static const size_t c_maxDfaStates{ 0x1000 };
+
+    enum class op_t : uint8_t
+    {
+        Set,    //byte from set m_sets[x]
+        Split,  //x with priority, y
+        Jmp,    //x
+        Save,   //group slot x
+        Bol,
+        Eol,
+        Match
+    };
+
+    struct Inst
+    {
+        op_t    op;
+        size_t  x{};
+        size_t  y{};
+    };
+
+    using ranges_t = std::vector<std::pair<uint32_t, uint32_t>>;
+    using byteset_t = std::bitset<256>;
+
+    enum class node_t
+    {
+        Empty,
+        Class,
+        Concat,
+        Alt,
+        Repeat,
+        Group,
+        Bol,
+        Eol
+    };
+
+    struct Node
+    {
+        node_t              type{ node_t::Empty };
+        ranges_t            ranges;
+        std::vector<Node>   sub;
+        size_t              min{};
+        size_t              max{};
+        bool                greedy{ true };
+        size_t              group{};
+    };
+
+    struct DfaState
+    {
+        std::vector<size_t>     pcs;
+        std::array<int, 256>    next;
+        bool                    match{};
+        bool                    matchEnd{};
+    };
+
+    struct Threads
+    {
+        std::vector<uint32_t>   mark;
+        uint32_t                gen{};
+        std::vector<size_t>     pcs;
+        std::vector<size_t>     caps;
+
+        void Init(size_t size);
+        void Clear();
+    };
+
+    struct Job
+    {
+        size_t  pc;
+        size_t  slot;
+        size_t  val;
+    };
+
+    bool                    m_checkCase;
+    bool                    m_utf8;
+    std::string             m_error;
+    size_t                  m_groups{};
+
+    std::string_view        m_pattern;
+    size_t                  m_pos{};
+
+    std::vector<Inst>       m_prog;
+    std::vector<byteset_t>  m_sets;
+
+    std::vector<DfaState>               m_dfa;
+    std::map<std::vector<size_t>, int>  m_dfaIndex;
+    std::vector<uint32_t>               m_mark;
+    uint32_t                            m_gen{};
+    std::vector<size_t>                 m_stack;
+
+    Threads                 m_clist;
+    Threads                 m_nlist;
+    std::vector<Job>        m_jobs;
+    std::vector<size_t>     m_caps;
+    std::vector<size_t>     m_found;
+
+    //string of previous match, next match in it is searched without DFA check
+    const char*             m_matchStr{};
+    size_t                  m_matchSize{};
+    size_t                  m_matchFrom{};
+
+    uint32_t    MaxChar() const { return m_utf8 ? 0x10ffff : 0xff; }
+    uint32_t    NextChar();
+    void        AddChar(ranges_t& ranges, uint32_t c);
+    void        AddRange(ranges_t& ranges, uint32_t lo, uint32_t hi);
+    void        Normalize(ranges_t& ranges);
+    void        Negate(ranges_t& ranges);
+
+    bool        ParseAlt(Node& node);
+    bool        ParseConcat(Node& node);
+    bool        ParseRepeat(Node& node);
+    bool        ParseCount(size_t& min, size_t& max);
+    bool        ParseAtom(Node& node);
+    bool        ParseClass(Node& node);
+    bool        ParseEscapeClass(ranges_t& ranges);
+    bool        ParseEscapeChar(uint32_t& c);
+
+    size_t      Emit(op_t op, size_t x = 0, size_t y = 0);
+    size_t      AddSet(const byteset_t& set);
+    void        SetSplit(size_t split, size_t body, size_t exit, bool greedy);
+    void        EmitNode(const Node& node);
+    void        EmitRepeat(const Node& node);
+    void        EmitClass(const ranges_t& ranges);
+    void        SplitUtf8(uint32_t lo, uint32_t hi, byteset_t& single, std::vector<std::vector<std::pair<uint8_t, uint8_t>>>& seqs);
+
+    void        NextGen();
+    void        Closure(size_t pc, bool bol, bool eol, std::vector<size_t>& pcs);
+    int         AddState(std::vector<size_t>&& pcs);
+    int         Transition(int state, uint8_t c);
+
+    void        AddThread(Threads& list, size_t pc, std::vector<size_t>& caps, size_t pos, size_t size);
+
+public:
+    //utf8 - pattern and strings are in UTF-8, otherwise each byte is a symbol
+    Regex(std::string_view pattern, bool checkCase = true, bool utf8 = true);
+
+    bool                IsValid() const         {return m_error.empty();}
+    const std::string&  GetError() const        {return m_error;}
+    size_t              GetGroupCount() const   {return m_groups;}
+
+    //check that the string contains match
+    bool                Search(std::string_view str);
+    //find leftmost match that begins from position 'from'
+    bool                Match(std::string_view str, size_t from, match_t& match);
+
+    //substitute \0-\9 in format with matched groups
+    static std::string  Expand(std::string_view str, const match_t& match, std::string_view format);
+};
+
+} //namespace _Utils
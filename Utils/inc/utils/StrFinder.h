@@ -0,0 +1,66 @@
+/*
+FreeBSD License
+
+Copyright (c) 2020-2021 vikonix: valeriy.kovalev.software@gmail.com
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#pragma once
+
+#include <array>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace _Utils
+{
+
+//////////////////////////////////////////////////////////////////////////////
+//Find string in raw data.
+//Every symbol of string is a list of encoded variants (for example upper and lower case).
+//Data are scanned with memchr by the first bytes of the most rare symbol.
+class StrFinder
+{
+public:
+    inline static const size_t npos{ std::string::npos };
+
+private:
+    inline static const size_t c_maxAnchors{ 4 };
+
+    std::vector<std::vector<std::string>>   m_symbols;
+    size_t                                  m_anchorOffset{};   //bytes from begin of string to anchor symbol
+    std::array<char, c_maxAnchors>          m_anchors{};        //first bytes of anchor symbol variants
+    size_t                                  m_anchorCount{};
+
+    void    SetAnchor();
+
+public:
+    bool    AddSymbol(std::vector<std::string>&& variants);
+    bool    Empty() const   {return m_symbols.empty();}
+
+    //length of string at the position or 0
+    size_t  Compare(std::string_view data, size_t pos) const;
+    //position of the first string in data beginning from 'from'
+    size_t  Find(std::string_view data, size_t from = 0) const;
+};
+
+} //namespace _Utils
@@ -25,11 +25,13 @@ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
 SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 #include "utils/CpConverter.h"
-#include "utils/IntervalMap.h"
 #include "utils/logger.h"
 #include "widecharwidth/widechar_width.h"
 
 #include <errno.h>
+#include <algorithm>
+#include <array>
+#include <vector>
 
 namespace iconvpp
 {
@@ -137,6 +139,47 @@ bool CpConverter::Convert(char16_t ch, std::string& out)
     return true;
 }
 
+bool CpConverter::Convert(std::u16string_view str, std::string& out)
+{
+    out.clear();
+    if (m_iconvTo == s_invalidIconv)
+        return false;
+
+    auto srcPtr = reinterpret_cast<const char*>(str.data());
+    size_t srcSize = str.size() * sizeof(char16_t);
+
+    out.resize(str.size() * 4);//4x reserve
+    auto dstPtr = out.data();
+    size_t dstSize = out.size();
+    size_t reserv = dstSize;
+
+    bool rc{ true };
+    while (srcSize)
+    {
+        size_t converted = iconv(m_iconvTo, &srcPtr, &srcSize, &dstPtr, &dstSize);
+        if (converted == static_cast<size_t>(-1))
+        {
+            rc = false;
+            if (errno == EINVAL || srcSize < sizeof(char16_t))
+            {
+                break;
+            }
+            else
+            {
+                //skip not convertible symbol
+                srcPtr += sizeof(char16_t);
+                srcSize -= sizeof(char16_t);
+                *dstPtr++ = '?';
+                --dstSize;
+            }
+        }
+    }
+
+    //resize out str
+    out.resize(reserv - dstSize);
+    return rc;
+}
+
 std::list<std::string> CpConverter::GetCpList()
 {
     return {
@@ -147,47 +190,82 @@ std::list<std::string> CpConverter::GetCpList()
     };
 }
 
-class WcWidth : public _Utils::IntervalMap<uint32_t, int>
+//two level width table for UTF-16 characters:
+//high byte selects one of shared blocks, low byte selects width in the block
+class WcWidth
 {
+    using block_t = std::array<int8_t, 0x100>;
+
+    std::array<uint8_t, 0x100>  m_index{};
+    std::vector<block_t>        m_blocks;
+
 public:
-    WcWidth() : IntervalMap(1)
-    { 
-        AddDiaps(widechar_widened_table, widechar_widened_in_9);
-        AddDiaps(widechar_unassigned_table, widechar_unassigned);
-        AddDiaps(widechar_ambiguous_table, widechar_ambiguous);
-        AddDiaps(widechar_doublewide_table, 2);
-        AddDiaps(widechar_combining_table, widechar_combining);
-        AddDiaps(widechar_nonchar_table, widechar_non_character);
-        AddDiaps(widechar_nonprint_table, widechar_nonprint);
-        AddDiaps(widechar_private_table, widechar_private_use);
+    WcWidth()
+    {
+        std::vector<int8_t> width(0x10000, 1);
+
+        //next table overrides previous
+        AddDiaps(width, widechar_widened_table, widechar_widened_in_9);
+        AddDiaps(width, widechar_unassigned_table, widechar_unassigned);
+        AddDiaps(width, widechar_ambiguous_table, widechar_ambiguous);
+        AddDiaps(width, widechar_doublewide_table, 2);
+        AddDiaps(width, widechar_combining_table, widechar_combining);
+        AddDiaps(width, widechar_nonchar_table, widechar_non_character);
+        AddDiaps(width, widechar_nonprint_table, widechar_nonprint);
+        AddDiaps(width, widechar_private_table, widechar_private_use);
+
+        for (size_t hi = 0; hi < m_index.size(); ++hi)
+        {
+            block_t block;
+            std::copy_n(width.begin() + hi * block.size(), block.size(), block.begin());
+
+            auto it = std::find(m_blocks.begin(), m_blocks.end(), block);
+            m_index[hi] = static_cast<uint8_t>(it - m_blocks.begin());
+            if (it == m_blocks.end())
+                m_blocks.push_back(block);
+        }
 
 #ifdef _DEBUG
         //check this class
-        for (uint32_t i = 0; i < 0x110000; ++i)
+        for (uint32_t i = 0; i < 0x10000; ++i)
         {
-            auto v1 = operator[](i);
+            auto v1 = operator[](static_cast<char16_t>(i));
             auto v2 = widechar_wcwidth(i);
             _assert(v1 == v2);
         }
 #endif
     }
-    
+
+    int operator[](char16_t c) const
+    {
+        return m_blocks[m_index[c >> 8]][c & 0xff];
+    }
+
     template<typename Collection>
-    void AddDiaps(const Collection& diaps, int value)
+    static void AddDiaps(std::vector<int8_t>& width, const Collection& diaps, int value)
     {
         for (auto& [kBegin, kEnd] : diaps)
-            AddInterval(kBegin, kEnd, value);
+            for (uint32_t c = kBegin; c <= kEnd && c < width.size(); ++c)
+                width[c] = static_cast<int8_t>(value);
     }
 };
 
 std::u16string CpConverter::FixPrintWidth(const std::u16string& str, size_t offset, size_t width)
 {
-    static WcWidth s_wcChar;
+    static const WcWidth s_wcChar;
 
     std::u16string fixed( width, ' ');
+    auto view = std::u16string_view(str).substr(offset, width);
+
+    //most of lines contain only ASCII symbols
+    if (std::all_of(view.begin(), view.end(), [](char16_t c) { return (c >= ' ' && c < 0x7f) || c == '\x9'; }))
+    {
+        std::copy(view.begin(), view.end(), fixed.begin());
+        return fixed;
+    }
 
     size_t pos{};
-    for (auto c : std::u16string_view(str).substr(offset, width))
+    for (auto c : view)
     {
         auto w = s_wcChar[c];
         if(w == 1 || w == widechar_ambiguous || c == '\x9')
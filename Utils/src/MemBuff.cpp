@@ -576,14 +576,13 @@ bool MemStrBuff<Tbuff, Tview>::AddStr(size_t n, const Tview str)
 
     //LOG(DEBUG) << "AddStr n=" << n << " '" << str << "'";
 
+    size_t _n = n;
     auto buff = GetBuff(n);
     if (!buff)
     {
         _assert(0);
         return false;
     }
-        
-    size_t _n = n;
 
     bool rc = (**buff)->AddStr(n, str);
     if (!rc)
@@ -639,17 +638,16 @@ bool MemStrBuff<Tbuff, Tview>::ChangeStr(size_t n, const Tview str)
     if (n >= m_totalStrCount)
         return false;
 
+    size_t _n = n;
     auto buff = GetBuff(n);
     if (!buff)
         return false;
 
-    size_t _n = n;
-
     bool rc = (**buff)->ChangeStr(n, str);
     if (!rc)
     {
         rc = SplitBuff(*buff, n);
-        if (!rc)
+        if (rc)
         {
             n = _n;
             buff = GetBuff(n);
@@ -0,0 +1,193 @@
+/*
+FreeBSD License
+
+Copyright (c) 2020-2021 vikonix: valeriy.kovalev.software@gmail.com
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "utils/MultiStrFinder.h"
+
+#include <algorithm>
+#include <queue>
+
+namespace _Utils
+{
+
+bool MultiStrFinder::AddString(const std::vector<std::vector<std::string>>& symbols, size_t id)
+{
+    //all combinations of symbol variants
+    std::vector<std::string> variants{ std::string{} };
+    for (auto& symbol : symbols)
+    {
+        std::vector<std::string> folded;
+        for (auto& v : symbol)
+        {
+            if (v.empty())
+                continue;
+            std::string str;
+            for (unsigned char c : v)
+                str += static_cast<char>(Fold(c));
+            folded.push_back(std::move(str));
+        }
+        std::sort(folded.begin(), folded.end());
+        folded.erase(std::unique(folded.begin(), folded.end()), folded.end());
+
+        if (folded.empty() || variants.size() * folded.size() > c_maxVariants)
+            return false;
+
+        std::vector<std::string> next;
+        next.reserve(variants.size() * folded.size());
+        for (auto& str : variants)
+            for (auto& v : folded)
+                next.push_back(str + v);
+        variants = std::move(next);
+    }
+
+    if (variants.size() == 1 && variants[0].empty())
+        return false;
+
+    for (auto& str : variants)
+        m_strings.emplace_back(std::move(str), id);
+    m_stateCount = 0;
+    return true;
+}
+
+bool MultiStrFinder::Build()
+{
+    m_class.fill(0);
+    m_classCount = 1;
+    for (auto& [str, id] : m_strings)
+        for (unsigned char c : str)
+            if (!m_class[c])
+                m_class[c] = static_cast<uint8_t>(m_classCount++);
+    if (m_foldCase)
+        for (unsigned char c = 'A'; c <= 'Z'; ++c)
+            m_class[c] = m_class[c + 0x20];
+
+    //trie
+    m_next.assign(m_classCount, c_none);
+    m_out.assign(1, c_none);
+    m_stateCount = 1;
+    for (size_t n = 0; n < m_strings.size(); ++n)
+    {
+        uint32_t state{};
+        for (unsigned char c : m_strings[n].first)
+        {
+            auto& next = m_next[state * m_classCount + m_class[c]];
+            if (next == c_none)
+            {
+                next = static_cast<uint32_t>(m_stateCount++);
+                m_next.resize(m_stateCount * m_classCount, c_none);
+                m_out.push_back(c_none);
+            }
+            state = m_next[state * m_classCount + m_class[c]];
+        }
+        if (m_out[state] == c_none)
+            m_out[state] = static_cast<uint32_t>(n);
+    }
+
+    //fail links are resolved to full transition table
+    std::vector<uint32_t> fail(m_stateCount);
+    m_dict.assign(m_stateCount, c_none);
+    std::queue<uint32_t> queue;
+    for (size_t c = 0; c < m_classCount; ++c)
+    {
+        auto& next = m_next[c];
+        if (next == c_none)
+            next = 0;
+        else
+            queue.push(next);
+    }
+
+    while (!queue.empty())
+    {
+        auto state = queue.front();
+        queue.pop();
+        auto f = fail[state];
+        m_dict[state] = m_out[f] != c_none ? f : m_dict[f];
+
+        for (size_t c = 0; c < m_classCount; ++c)
+        {
+            auto& next = m_next[state * m_classCount + c];
+            if (next == c_none)
+                next = m_next[f * m_classCount + c];
+            else
+            {
+                fail[next] = m_next[f * m_classCount + c];
+                queue.push(next);
+            }
+        }
+    }
+
+    return m_stateCount > 1;
+}
+
+size_t MultiStrFinder::Find(std::string_view data, size_t from) const
+{
+    if (m_stateCount <= 1)
+        return npos;
+
+    auto next = m_next.data();
+    uint32_t state{};
+    for (size_t i = from; i < data.size(); ++i)
+    {
+        state = next[state * m_classCount + m_class[static_cast<unsigned char>(data[i])]];
+        auto out = m_out[state] != c_none ? state : m_dict[state];
+        if (out != c_none)
+            return i + 1 - m_strings[m_out[out]].first.size();
+    }
+
+    return npos;
+}
+
+void MultiStrFinder::FindAll(std::string_view data, std::vector<Match>& found) const
+{
+    found.clear();
+    if (m_stateCount <= 1)
+        return;
+
+    std::vector<Match> all;
+    uint32_t state{};
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        state = m_next[state * m_classCount + m_class[static_cast<unsigned char>(data[i])]];
+        for (auto out = m_out[state] != c_none ? state : m_dict[state]; out != c_none; out = m_dict[out])
+        {
+            auto& [str, id] = m_strings[m_out[out]];
+            all.push_back({ i + 1 - str.size(), str.size(), id });
+        }
+    }
+
+    std::stable_sort(all.begin(), all.end(), [](const Match& m1, const Match& m2) {
+        return m1.pos < m2.pos || (m1.pos == m2.pos && m1.size > m2.size);
+    });
+
+    size_t end{};
+    for (auto& match : all)
+        if (match.pos >= end)
+        {
+            found.push_back(match);
+            end = match.pos + match.size;
+        }
+}
+
+} //namespace _Utils
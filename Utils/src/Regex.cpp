@@ -0,0 +1,1059 @@
+/*
+FreeBSD License
+
+Copyright (c) 2020-2021 vikonix: valeriy.kovalev.software@gmail.com
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "utils/Regex.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cwctype>
+
+namespace _Utils
+{
+
+/////////////////////////////////////////////////////////////////////////////
+void Regex::Threads::Init(size_t size)
+{
+    if (mark.size() != size)
+    {
+        mark.assign(size, 0);
+        gen = 1;
+    }
+    Clear();
+}
+
+void Regex::Threads::Clear()
+{
+    pcs.clear();
+    caps.clear();
+    if (++gen == 0)
+    {
+        std::fill(mark.begin(), mark.end(), 0);
+        gen = 1;
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+Regex::Regex(std::string_view pattern, bool checkCase, bool utf8)
+    : m_checkCase{ checkCase }
+    , m_utf8{ utf8 }
+    , m_pattern{ pattern }
+{
+    Node root;
+    if (ParseAlt(root) && m_pos < m_pattern.size())
+        m_error = "Unmatched )";
+
+    if (m_error.empty())
+    {
+        Emit(op_t::Save, 0);
+        EmitNode(root);
+        Emit(op_t::Save, 1);
+        Emit(op_t::Match);
+    }
+
+    if (!m_error.empty())
+    {
+        m_prog.clear();
+        m_sets.clear();
+    }
+
+    m_pattern = {};
+}
+
+uint32_t Regex::NextChar()
+{
+    auto c = static_cast<uint8_t>(m_pattern[m_pos++]);
+    if (!m_utf8 || c < 0xc0)
+        return c;
+
+    size_t n = c >= 0xf0 ? 3 : c >= 0xe0 ? 2 : 1;
+    if (m_pos + n > m_pattern.size())
+        return c;
+
+    uint32_t cp = c & (0x3f >> n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        auto b = static_cast<uint8_t>(m_pattern[m_pos + i]);
+        if ((b & 0xc0) != 0x80)
+            return c;
+        cp = (cp << 6) | (b & 0x3f);
+    }
+
+    m_pos += n;
+    return cp;
+}
+
+void Regex::AddChar(ranges_t& ranges, uint32_t c)
+{
+    ranges.emplace_back(c, c);
+    if (m_checkCase)
+        return;
+
+    if (c < 0x80)
+    {
+        if (c >= 'a' && c <= 'z')
+            ranges.emplace_back(c - 0x20, c - 0x20);
+        else if (c >= 'A' && c <= 'Z')
+            ranges.emplace_back(c + 0x20, c + 0x20);
+    }
+    else if (m_utf8)
+    {
+        auto u = static_cast<uint32_t>(std::towupper(static_cast<wint_t>(c)));
+        auto l = static_cast<uint32_t>(std::towlower(static_cast<wint_t>(c)));
+        if (u != c)
+            ranges.emplace_back(u, u);
+        if (l != c)
+            ranges.emplace_back(l, l);
+    }
+}
+
+void Regex::AddRange(ranges_t& ranges, uint32_t lo, uint32_t hi)
+{
+    ranges.emplace_back(lo, hi);
+    if (m_checkCase)
+        return;
+
+    auto addCase = [&ranges, lo, hi](uint32_t first, uint32_t last, int32_t shift) {
+        auto b = std::max(lo, first);
+        auto e = std::min(hi, last);
+        if (b <= e)
+            ranges.emplace_back(b + shift, e + shift);
+    };
+    addCase('a', 'z', -0x20);
+    addCase('A', 'Z', 0x20);
+
+    //fold not big ranges of national symbols
+    if (m_utf8 && hi >= 0x80 && hi - lo < 0x800)
+        for (auto c = std::max<uint32_t>(lo, 0x80); c <= hi; ++c)
+            AddChar(ranges, c);
+}
+
+void Regex::Normalize(ranges_t& ranges)
+{
+    if (ranges.empty())
+        return;
+
+    std::sort(ranges.begin(), ranges.end());
+    size_t n{};
+    for (size_t i = 1; i < ranges.size(); ++i)
+    {
+        if (ranges[i].first <= ranges[n].second + 1)
+            ranges[n].second = std::max(ranges[n].second, ranges[i].second);
+        else
+            ranges[++n] = ranges[i];
+    }
+    ranges.resize(n + 1);
+}
+
+void Regex::Negate(ranges_t& ranges)
+{
+    Normalize(ranges);
+
+    ranges_t out;
+    uint32_t next{};
+    for (auto [lo, hi] : ranges)
+    {
+        if (lo > next)
+            out.emplace_back(next, lo - 1);
+        next = hi + 1;
+    }
+    if (next <= MaxChar())
+        out.emplace_back(next, MaxChar());
+
+    ranges.swap(out);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+bool Regex::ParseAlt(Node& node)
+{
+    Node alt;
+    alt.type = node_t::Alt;
+    while (1)
+    {
+        Node seq;
+        if (!ParseConcat(seq))
+            return false;
+        alt.sub.push_back(std::move(seq));
+
+        if (m_pos >= m_pattern.size() || m_pattern[m_pos] != '|')
+            break;
+        ++m_pos;
+    }
+
+    if (alt.sub.size() == 1)
+        node = std::move(alt.sub[0]);
+    else
+        node = std::move(alt);
+    return true;
+}
+
+bool Regex::ParseConcat(Node& node)
+{
+    Node seq;
+    seq.type = node_t::Concat;
+    while (m_pos < m_pattern.size() && m_pattern[m_pos] != '|' && m_pattern[m_pos] != ')')
+    {
+        Node item;
+        if (!ParseRepeat(item))
+            return false;
+        seq.sub.push_back(std::move(item));
+    }
+
+    if (seq.sub.empty())
+        node = Node{};
+    else if (seq.sub.size() == 1)
+        node = std::move(seq.sub[0]);
+    else
+        node = std::move(seq);
+    return true;
+}
+
+bool Regex::ParseRepeat(Node& node)
+{
+    if (!ParseAtom(node))
+        return false;
+
+    while (m_pos < m_pattern.size())
+    {
+        size_t min{}, max{};
+        auto c = m_pattern[m_pos];
+        if (c == '*' || c == '+' || c == '?')
+        {
+            min = c == '+' ? 1 : 0;
+            max = c == '?' ? 1 : npos;
+            ++m_pos;
+        }
+        else if (c != '{' || !ParseCount(min, max))
+        {
+            if (!m_error.empty())
+                return false;
+            break;
+        }
+
+        Node rep;
+        rep.type = node_t::Repeat;
+        rep.min = min;
+        rep.max = max;
+        if (m_pos < m_pattern.size() && m_pattern[m_pos] == '?')
+        {
+            rep.greedy = false;
+            ++m_pos;
+        }
+        rep.sub.push_back(std::move(node));
+        node = std::move(rep);
+    }
+
+    return true;
+}
+
+bool Regex::ParseCount(size_t& min, size_t& max)
+{
+    //{n} {n,} {n,m}, otherwise '{' is a literal
+    size_t pos = m_pos + 1;
+    auto number = [this, &pos](size_t& n) -> bool {
+        size_t begin = pos;
+        n = 0;
+        while (pos < m_pattern.size() && m_pattern[pos] >= '0' && m_pattern[pos] <= '9')
+        {
+            n = std::min(n * 10 + (m_pattern[pos] - '0'), c_maxRepeat + 1);
+            ++pos;
+        }
+        return pos > begin;
+    };
+
+    if (!number(min))
+        return false;
+    max = min;
+    if (pos < m_pattern.size() && m_pattern[pos] == ',')
+    {
+        ++pos;
+        if (!number(max))
+            max = npos;
+    }
+    if (pos >= m_pattern.size() || m_pattern[pos] != '}')
+        return false;
+
+    if (min > c_maxRepeat || (max != npos && (max > c_maxRepeat || max < min)))
+    {
+        m_error = "Invalid repeat count";
+        return false;
+    }
+
+    m_pos = pos + 1;
+    return true;
+}
+
+bool Regex::ParseAtom(Node& node)
+{
+    auto c = m_pattern[m_pos];
+    switch (c)
+    {
+    case '(':
+    {
+        ++m_pos;
+        size_t group{};
+        if (m_pattern.substr(m_pos, 2) == "?:")
+            m_pos += 2;
+        else if (m_groups + 1 < c_maxGroups)
+            group = ++m_groups;
+
+        Node sub;
+        if (!ParseAlt(sub))
+            return false;
+        if (m_pos >= m_pattern.size() || m_pattern[m_pos] != ')')
+        {
+            m_error = "Missing )";
+            return false;
+        }
+        ++m_pos;
+
+        if (group)
+        {
+            node.type = node_t::Group;
+            node.group = group;
+            node.sub.push_back(std::move(sub));
+        }
+        else
+            node = std::move(sub);
+        return true;
+    }
+    case '[':
+        ++m_pos;
+        return ParseClass(node);
+    case '.':
+        ++m_pos;
+        node.type = node_t::Class;
+        node.ranges = { {0, '\n' - 1}, {'\n' + 1, MaxChar()} };
+        return true;
+    case '^':
+        ++m_pos;
+        node.type = node_t::Bol;
+        return true;
+    case '$':
+        ++m_pos;
+        node.type = node_t::Eol;
+        return true;
+    case '*':
+    case '+':
+    case '?':
+        m_error = "Nothing to repeat";
+        return false;
+    case '\\':
+        ++m_pos;
+        if (m_pos >= m_pattern.size())
+        {
+            m_error = "Trailing \\";
+            return false;
+        }
+        node.type = node_t::Class;
+        if (!ParseEscapeClass(node.ranges))
+        {
+            uint32_t ch;
+            if (!ParseEscapeChar(ch))
+                return false;
+            AddChar(node.ranges, ch);
+        }
+        Normalize(node.ranges);
+        return true;
+    default:
+        node.type = node_t::Class;
+        AddChar(node.ranges, NextChar());
+        Normalize(node.ranges);
+        return true;
+    }
+}
+
+bool Regex::ParseClass(Node& node)
+{
+    node.type = node_t::Class;
+
+    bool negate{};
+    if (m_pos < m_pattern.size() && m_pattern[m_pos] == '^')
+    {
+        negate = true;
+        ++m_pos;
+    }
+
+    ranges_t ranges;
+    bool first{ true };
+    while (1)
+    {
+        if (m_pos >= m_pattern.size())
+        {
+            m_error = "Missing ]";
+            return false;
+        }
+
+        auto c = m_pattern[m_pos];
+        if (c == ']' && !first)
+        {
+            ++m_pos;
+            break;
+        }
+        first = false;
+
+        uint32_t lo;
+        if (c == '\\')
+        {
+            if (++m_pos >= m_pattern.size())
+                continue;
+            if (ParseEscapeClass(ranges))
+                continue;
+            if (!ParseEscapeChar(lo))
+                return false;
+        }
+        else
+            lo = NextChar();
+
+        uint32_t hi{ lo };
+        if (m_pos + 1 < m_pattern.size() && m_pattern[m_pos] == '-' && m_pattern[m_pos + 1] != ']')
+        {
+            ++m_pos;
+            if (m_pattern[m_pos] == '\\')
+            {
+                if (++m_pos >= m_pattern.size())
+                    continue;
+                if (!ParseEscapeChar(hi))
+                    return false;
+            }
+            else
+                hi = NextChar();
+
+            if (hi < lo)
+            {
+                m_error = "Invalid range";
+                return false;
+            }
+        }
+        AddRange(ranges, lo, hi);
+    }
+
+    if (negate)
+        Negate(ranges);
+    else
+        Normalize(ranges);
+    node.ranges = std::move(ranges);
+
+    return true;
+}
+
+bool Regex::ParseEscapeClass(ranges_t& ranges)
+{
+    static const ranges_t digit{ {'0', '9'} };
+    static const ranges_t word{ {'0', '9'}, {'A', 'Z'}, {'_', '_'}, {'a', 'z'} };
+    static const ranges_t space{ {'\t', '\r'}, {' ', ' '} };
+
+    ranges_t add;
+    switch (m_pattern[m_pos])
+    {
+    case 'd':
+    case 'D':
+        add = digit;
+        break;
+    case 'w':
+    case 'W':
+        add = word;
+        break;
+    case 's':
+    case 'S':
+        add = space;
+        break;
+    default:
+        return false;
+    }
+
+    if (std::isupper(static_cast<unsigned char>(m_pattern[m_pos])))
+        Negate(add);
+    ++m_pos;
+
+    ranges.insert(ranges.end(), add.cbegin(), add.cend());
+    return true;
+}
+
+bool Regex::ParseEscapeChar(uint32_t& c)
+{
+    switch (m_pattern[m_pos])
+    {
+    case 't':
+        c = '\t';
+        break;
+    case 'n':
+        c = '\n';
+        break;
+    case 'r':
+        c = '\r';
+        break;
+    case 'f':
+        c = '\f';
+        break;
+    case 'v':
+        c = '\v';
+        break;
+    case 'x':
+    {
+        auto hex = [](char h) -> int {
+            if (h >= '0' && h <= '9')
+                return h - '0';
+            h |= 0x20;
+            if (h >= 'a' && h <= 'f')
+                return h - 'a' + 10;
+            return -1;
+        };
+
+        if (m_pos + 2 >= m_pattern.size() || hex(m_pattern[m_pos + 1]) < 0 || hex(m_pattern[m_pos + 2]) < 0)
+        {
+            m_error = "Invalid \\x";
+            return false;
+        }
+        c = static_cast<uint32_t>(hex(m_pattern[m_pos + 1]) * 16 + hex(m_pattern[m_pos + 2]));
+        m_pos += 3;
+        return true;
+    }
+    default:
+        c = NextChar();
+        return true;
+    }
+
+    ++m_pos;
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+size_t Regex::Emit(op_t op, size_t x, size_t y)
+{
+    if (m_prog.size() >= c_maxInst && m_error.empty())
+        m_error = "Expression too big";
+
+    m_prog.push_back({ op, x, y });
+    return m_prog.size() - 1;
+}
+
+size_t Regex::AddSet(const byteset_t& set)
+{
+    auto it = std::find(m_sets.cbegin(), m_sets.cend(), set);
+    if (it != m_sets.cend())
+        return std::distance(m_sets.cbegin(), it);
+
+    m_sets.push_back(set);
+    return m_sets.size() - 1;
+}
+
+void Regex::SetSplit(size_t split, size_t body, size_t exit, bool greedy)
+{
+    m_prog[split].x = greedy ? body : exit;
+    m_prog[split].y = greedy ? exit : body;
+}
+
+void Regex::EmitNode(const Node& node)
+{
+    if (!m_error.empty())
+        return;
+
+    switch (node.type)
+    {
+    case node_t::Empty:
+        break;
+    case node_t::Class:
+        EmitClass(node.ranges);
+        break;
+    case node_t::Concat:
+        for (auto& sub : node.sub)
+            EmitNode(sub);
+        break;
+    case node_t::Alt:
+    {
+        std::vector<size_t> jumps;
+        for (size_t i = 0; i < node.sub.size(); ++i)
+        {
+            if (i + 1 < node.sub.size())
+            {
+                auto split = Emit(op_t::Split);
+                EmitNode(node.sub[i]);
+                jumps.push_back(Emit(op_t::Jmp));
+                SetSplit(split, split + 1, m_prog.size(), true);
+            }
+            else
+                EmitNode(node.sub[i]);
+        }
+        for (auto jmp : jumps)
+            m_prog[jmp].x = m_prog.size();
+        break;
+    }
+    case node_t::Repeat:
+        EmitRepeat(node);
+        break;
+    case node_t::Group:
+        Emit(op_t::Save, node.group * 2);
+        EmitNode(node.sub[0]);
+        Emit(op_t::Save, node.group * 2 + 1);
+        break;
+    case node_t::Bol:
+        Emit(op_t::Bol);
+        break;
+    case node_t::Eol:
+        Emit(op_t::Eol);
+        break;
+    }
+}
+
+void Regex::EmitRepeat(const Node& node)
+{
+    auto& sub = node.sub[0];
+    for (size_t i = 0; i < node.min && m_error.empty(); ++i)
+        EmitNode(sub);
+
+    if (node.max == npos)
+    {
+        auto split = Emit(op_t::Split);
+        EmitNode(sub);
+        Emit(op_t::Jmp, split);
+        SetSplit(split, split + 1, m_prog.size(), node.greedy);
+    }
+    else
+    {
+        std::vector<size_t> splits;
+        for (size_t i = node.min; i < node.max && m_error.empty(); ++i)
+        {
+            splits.push_back(Emit(op_t::Split));
+            EmitNode(sub);
+        }
+        for (auto split : splits)
+            SetSplit(split, split + 1, m_prog.size(), node.greedy);
+    }
+}
+
+void Regex::EmitClass(const ranges_t& ranges)
+{
+    if (!m_utf8)
+    {
+        byteset_t set;
+        for (auto [lo, hi] : ranges)
+            for (auto c = lo; c <= hi && c <= 0xff; ++c)
+                set.set(c);
+        Emit(op_t::Set, AddSet(set));
+        return;
+    }
+
+    //alternation of UTF-8 byte sequences
+    byteset_t single;
+    std::vector<std::vector<std::pair<uint8_t, uint8_t>>> seqs;
+    for (auto [lo, hi] : ranges)
+        SplitUtf8(lo, hi, single, seqs);
+
+    size_t first = single.any() ? 1 : 0;
+    size_t count = seqs.size() + first;
+    if (count == 0)
+    {
+        //never matches
+        Emit(op_t::Set, AddSet({}));
+        return;
+    }
+
+    std::vector<size_t> jumps;
+    for (size_t i = 0; i < count; ++i)
+    {
+        size_t split{ npos };
+        if (i + 1 < count)
+            split = Emit(op_t::Split);
+
+        if (i < first)
+            Emit(op_t::Set, AddSet(single));
+        else
+            for (auto [lo, hi] : seqs[i - first])
+            {
+                byteset_t set;
+                for (size_t c = lo; c <= hi; ++c)
+                    set.set(c);
+                Emit(op_t::Set, AddSet(set));
+            }
+
+        if (split != npos)
+        {
+            jumps.push_back(Emit(op_t::Jmp));
+            SetSplit(split, split + 1, m_prog.size(), true);
+        }
+    }
+    for (auto jmp : jumps)
+        m_prog[jmp].x = m_prog.size();
+}
+
+void Regex::SplitUtf8(uint32_t lo, uint32_t hi, byteset_t& single, std::vector<std::vector<std::pair<uint8_t, uint8_t>>>& seqs)
+{
+    if (lo > hi)
+        return;
+
+    //split by encoded length
+    for (uint32_t bound : {0x7f, 0x7ff, 0xffff})
+        if (lo <= bound && hi > bound)
+        {
+            SplitUtf8(lo, bound, single, seqs);
+            SplitUtf8(bound + 1, hi, single, seqs);
+            return;
+        }
+
+    if (hi <= 0x7f)
+    {
+        for (auto c = lo; c <= hi; ++c)
+            single.set(c);
+        return;
+    }
+
+    //split until each byte of sequence is an independent range
+    for (size_t i = 1; i < 4; ++i)
+    {
+        uint32_t m = (1u << (6 * i)) - 1;
+        if ((lo & ~m) != (hi & ~m))
+        {
+            if ((lo & m) != 0)
+            {
+                SplitUtf8(lo, lo | m, single, seqs);
+                SplitUtf8((lo | m) + 1, hi, single, seqs);
+                return;
+            }
+            if ((hi & m) != m)
+            {
+                SplitUtf8(lo, (hi & ~m) - 1, single, seqs);
+                SplitUtf8(hi & ~m, hi, single, seqs);
+                return;
+            }
+        }
+    }
+
+    auto encode = [](uint32_t c) -> std::vector<uint8_t> {
+        if (c <= 0x7ff)
+            return { static_cast<uint8_t>(0xc0 | (c >> 6)), static_cast<uint8_t>(0x80 | (c & 0x3f)) };
+        else if (c <= 0xffff)
+            return { static_cast<uint8_t>(0xe0 | (c >> 12)), static_cast<uint8_t>(0x80 | ((c >> 6) & 0x3f)),
+                static_cast<uint8_t>(0x80 | (c & 0x3f)) };
+        else
+            return { static_cast<uint8_t>(0xf0 | (c >> 18)), static_cast<uint8_t>(0x80 | ((c >> 12) & 0x3f)),
+                static_cast<uint8_t>(0x80 | ((c >> 6) & 0x3f)), static_cast<uint8_t>(0x80 | (c & 0x3f)) };
+    };
+
+    auto b = encode(lo);
+    auto e = encode(hi);
+    std::vector<std::pair<uint8_t, uint8_t>> seq;
+    for (size_t i = 0; i < b.size(); ++i)
+        seq.emplace_back(b[i], e[i]);
+    seqs.push_back(std::move(seq));
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void Regex::NextGen()
+{
+    if (m_mark.size() != m_prog.size())
+    {
+        m_mark.assign(m_prog.size(), 0);
+        m_gen = 0;
+    }
+    if (++m_gen == 0)
+    {
+        std::fill(m_mark.begin(), m_mark.end(), 0);
+        m_gen = 1;
+    }
+}
+
+void Regex::Closure(size_t pc, bool bol, bool eol, std::vector<size_t>& pcs)
+{
+    m_stack.clear();
+    m_stack.push_back(pc);
+    while (!m_stack.empty())
+    {
+        pc = m_stack.back();
+        m_stack.pop_back();
+        if (m_mark[pc] == m_gen)
+            continue;
+        m_mark[pc] = m_gen;
+
+        auto& inst = m_prog[pc];
+        switch (inst.op)
+        {
+        case op_t::Jmp:
+            m_stack.push_back(inst.x);
+            break;
+        case op_t::Split:
+            m_stack.push_back(inst.y);
+            m_stack.push_back(inst.x);
+            break;
+        case op_t::Save:
+            m_stack.push_back(pc + 1);
+            break;
+        case op_t::Bol:
+            if (bol)
+                m_stack.push_back(pc + 1);
+            break;
+        case op_t::Eol:
+            //keep unresolved till the end of string
+            if (eol)
+                m_stack.push_back(pc + 1);
+            else
+                pcs.push_back(pc);
+            break;
+        default:
+            pcs.push_back(pc);
+            break;
+        }
+    }
+}
+
+int Regex::AddState(std::vector<size_t>&& pcs)
+{
+    std::sort(pcs.begin(), pcs.end());
+    if (auto it = m_dfaIndex.find(pcs); it != m_dfaIndex.end())
+        return it->second;
+
+    DfaState state;
+    state.next.fill(-1);
+    for (auto pc : pcs)
+        if (m_prog[pc].op == op_t::Match)
+            state.match = true;
+
+    state.matchEnd = state.match;
+    if (!state.match)
+    {
+        std::vector<size_t> end;
+        NextGen();
+        for (auto pc : pcs)
+            if (m_prog[pc].op == op_t::Eol)
+                Closure(pc + 1, false, true, end);
+        for (auto pc : end)
+            if (m_prog[pc].op == op_t::Match)
+                state.matchEnd = true;
+    }
+
+    int index = static_cast<int>(m_dfa.size());
+    m_dfaIndex.emplace(pcs, index);
+    state.pcs = std::move(pcs);
+    m_dfa.push_back(std::move(state));
+
+    return index;
+}
+
+int Regex::Transition(int state, uint8_t c)
+{
+    std::vector<size_t> pcs;
+    NextGen();
+    for (auto pc : m_dfa[state].pcs)
+    {
+        auto& inst = m_prog[pc];
+        if (inst.op == op_t::Set && m_sets[inst.x][c])
+            Closure(pc + 1, false, false, pcs);
+    }
+    //unanchored search restarts at each position
+    Closure(0, false, false, pcs);
+
+    if (m_dfa.size() >= c_maxDfaStates)
+    {
+        //cache is full, begin it again
+        m_dfa.clear();
+        m_dfaIndex.clear();
+        std::vector<size_t> start;
+        NextGen();
+        Closure(0, true, false, start);
+        AddState(std::move(start));
+        return AddState(std::move(pcs));
+    }
+
+    int next = AddState(std::move(pcs));
+    m_dfa[state].next[c] = next;
+    return next;
+}
+
+bool Regex::Search(std::string_view str)
+{
+    if (!m_error.empty())
+        return false;
+
+    if (m_dfa.empty())
+    {
+        std::vector<size_t> start;
+        NextGen();
+        Closure(0, true, false, start);
+        AddState(std::move(start));
+    }
+
+    int state{};
+    for (auto c : str)
+    {
+        if (m_dfa[state].match)
+            return true;
+
+        auto b = static_cast<uint8_t>(c);
+        int next = m_dfa[state].next[b];
+        if (next < 0)
+            next = Transition(state, b);
+        state = next;
+    }
+
+    return m_dfa[state].matchEnd;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void Regex::AddThread(Threads& list, size_t pc, std::vector<size_t>& caps, size_t pos, size_t size)
+{
+    m_jobs.clear();
+    m_jobs.push_back({ pc, npos, 0 });
+    while (!m_jobs.empty())
+    {
+        auto job = m_jobs.back();
+        m_jobs.pop_back();
+        if (job.slot != npos)
+        {
+            //restore group position
+            caps[job.slot] = job.val;
+            continue;
+        }
+
+        pc = job.pc;
+        if (list.mark[pc] == list.gen)
+            continue;
+        list.mark[pc] = list.gen;
+
+        auto& inst = m_prog[pc];
+        switch (inst.op)
+        {
+        case op_t::Jmp:
+            m_jobs.push_back({ inst.x, npos, 0 });
+            break;
+        case op_t::Split:
+            m_jobs.push_back({ inst.y, npos, 0 });
+            m_jobs.push_back({ inst.x, npos, 0 });
+            break;
+        case op_t::Save:
+            m_jobs.push_back({ 0, inst.x, caps[inst.x] });
+            caps[inst.x] = pos;
+            m_jobs.push_back({ pc + 1, npos, 0 });
+            break;
+        case op_t::Bol:
+            if (pos == 0)
+                m_jobs.push_back({ pc + 1, npos, 0 });
+            break;
+        case op_t::Eol:
+            if (pos == size)
+                m_jobs.push_back({ pc + 1, npos, 0 });
+            break;
+        default:
+            list.pcs.push_back(pc);
+            list.caps.insert(list.caps.end(), caps.cbegin(), caps.cend());
+            break;
+        }
+    }
+}
+
+bool Regex::Match(std::string_view str, size_t from, match_t& match)
+{
+    match.clear();
+    if (!m_error.empty() || from > str.size())
+        return false;
+
+    //fast check with DFA only for the first match in string,
+    //next one is searched from previous position without scanning the rest of string again
+    bool resume = str.data() == m_matchStr && str.size() == m_matchSize && from >= m_matchFrom;
+    m_matchStr = nullptr;
+    if (!resume && !Search(str.substr(from)))
+        return false;
+
+    size_t slots = (m_groups + 1) * 2;
+    m_clist.Init(m_prog.size());
+    m_nlist.Init(m_prog.size());
+
+    auto& caps = m_caps;
+    auto& found = m_found;
+    caps.assign(slots, npos);
+    found.clear();
+    for (size_t pos = from; ; ++pos)
+    {
+        if (found.empty())
+        {
+            std::fill(caps.begin(), caps.end(), npos);
+            AddThread(m_clist, 0, caps, pos, str.size());
+        }
+        else if (m_clist.pcs.empty())
+            break;
+
+        m_nlist.Clear();
+        for (size_t i = 0; i < m_clist.pcs.size(); ++i)
+        {
+            auto& inst = m_prog[m_clist.pcs[i]];
+            auto threadCaps = m_clist.caps.cbegin() + i * slots;
+            if (inst.op == op_t::Match)
+            {
+                //cut off threads with lower priority
+                found.assign(threadCaps, threadCaps + slots);
+                break;
+            }
+            if (pos < str.size() && m_sets[inst.x][static_cast<uint8_t>(str[pos])])
+            {
+                caps.assign(threadCaps, threadCaps + slots);
+                AddThread(m_nlist, m_clist.pcs[i] + 1, caps, pos + 1, str.size());
+            }
+        }
+
+        if (pos >= str.size())
+            break;
+        std::swap(m_clist, m_nlist);
+    }
+
+    if (found.empty())
+        return false;
+
+    m_matchStr = str.data();
+    m_matchSize = str.size();
+    m_matchFrom = from;
+
+    match.resize(m_groups + 1, { npos, npos });
+    for (size_t i = 0; i <= m_groups; ++i)
+        if (found[i * 2] != npos && found[i * 2 + 1] != npos)
+            match[i] = { found[i * 2], found[i * 2 + 1] };
+
+    return true;
+}
+
+std::string Regex::Expand(std::string_view str, const match_t& match, std::string_view format)
+{
+    std::string out;
+    for (size_t i = 0; i < format.size(); ++i)
+    {
+        auto c = format[i];
+        if (c == '\\' && i + 1 < format.size())
+        {
+            c = format[++i];
+            if (c >= '0' && c <= '9')
+            {
+                size_t n = c - '0';
+                if (n < match.size() && match[n].first != npos)
+                    out += str.substr(match[n].first, match[n].second - match[n].first);
+                continue;
+            }
+            else if (c == 't')
+                c = '\t';
+        }
+        out += c;
+    }
+
+    return out;
+}
+
+} //namespace _Utils
@@ -0,0 +1,155 @@
+/*
+FreeBSD License
+
+Copyright (c) 2020-2021 vikonix: valeriy.kovalev.software@gmail.com
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+#include "utils/StrFinder.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace _Utils
+{
+
+bool StrFinder::AddSymbol(std::vector<std::string>&& variants)
+{
+    variants.erase(std::remove_if(variants.begin(), variants.end(), [](const std::string& v) { return v.empty(); }), variants.end());
+    if (variants.empty())
+        return false;
+
+    std::sort(variants.begin(), variants.end());
+    variants.erase(std::unique(variants.begin(), variants.end()), variants.end());
+
+    m_symbols.push_back(std::move(variants));
+    SetAnchor();
+    return true;
+}
+
+void StrFinder::SetAnchor()
+{
+    //frequent bytes are worse for memchr
+    auto rank = [](unsigned char c) -> size_t {
+        if ((c >= 'a' && c <= 'z') || c == ' ' || c >= 0x80)
+            return 2;
+        if ((c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9'))
+            return 1;
+        return 0;
+    };
+
+    size_t best{ npos };
+    size_t offset{};
+    for (auto& symbol : m_symbols)
+    {
+        std::string first;
+        size_t score{};
+        for (auto& v : symbol)
+            if (first.find(v[0]) == std::string::npos)
+            {
+                first += v[0];
+                score = std::max(score, rank(static_cast<unsigned char>(v[0])));
+            }
+
+        score += first.size() * 3;
+        if (first.size() <= c_maxAnchors && score < best)
+        {
+            best = score;
+            m_anchorOffset = offset;
+            m_anchorCount = first.size();
+            std::copy(first.cbegin(), first.cend(), m_anchors.begin());
+        }
+
+        //anchor offset must be fixed
+        auto size = symbol[0].size();
+        if (std::any_of(symbol.cbegin(), symbol.cend(), [size](const std::string& v) { return v.size() != size; }))
+            break;
+        offset += size;
+    }
+}
+
+size_t StrFinder::Compare(std::string_view data, size_t pos) const
+{
+    size_t p{ pos };
+    for (auto& symbol : m_symbols)
+    {
+        bool found{};
+        for (auto& v : symbol)
+            if (data.compare(p, v.size(), v) == 0)
+            {
+                p += v.size();
+                found = true;
+                break;
+            }
+
+        if (!found)
+            return 0;
+    }
+
+    return p - pos;
+}
+
+size_t StrFinder::Find(std::string_view data, size_t from) const
+{
+    if (m_symbols.empty() || from + m_anchorOffset >= data.size())
+        return npos;
+
+    if (m_anchorCount == 0)
+    {
+        for (size_t start = from; start < data.size(); ++start)
+            if (Compare(data, start))
+                return start;
+        return npos;
+    }
+
+    const char* begin = data.data();
+    const char* end = begin + data.size();
+    auto next = [end](const char* p, char c) -> const char* {
+        auto found = std::memchr(p, c, end - p);
+        return found ? static_cast<const char*>(found) : end;
+    };
+
+    //next position of each anchor byte
+    std::array<const char*, c_maxAnchors> pos;
+    for (size_t i = 0; i < m_anchorCount; ++i)
+        pos[i] = next(begin + from + m_anchorOffset, m_anchors[i]);
+
+    while (1)
+    {
+        size_t n{};
+        for (size_t i = 1; i < m_anchorCount; ++i)
+            if (pos[i] < pos[n])
+                n = i;
+
+        const char* p = pos[n];
+        if (p == end)
+            return npos;
+
+        size_t start = p - begin - m_anchorOffset;
+        if (Compare(data, start))
+            return start;
+
+        pos[n] = next(p + 1, m_anchors[n]);
+    }
+}
+
+} //namespace _Utils
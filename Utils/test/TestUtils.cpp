@@ -31,8 +31,15 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "utils/logger.h"
 #include "utils/Directory.h"
 #include "utils/MemBuff.h"
+#include "utils/Regex.h"
+#include "utils/StrFinder.h"
+#include "utils/MultiStrFinder.h"
+#include "utils/CpConverter.h"
+#include "widecharwidth/widechar_width.h"
 
+#include <chrono>
 #include <iostream>
+#include <regex>
 
 /////////////////////////////////////////////////////////////////////////////
 using namespace _Utils;
@@ -121,6 +128,183 @@ void BuffTest()
     }
 }
 
+void StrFinderTest()
+{
+    LOG(DEBUG) << "Test: " << __FUNC__;
+
+    StrFinder finder;
+    for (auto c : std::string("find"))
+        finder.AddSymbol({ std::string(1, c), std::string(1, static_cast<char>(std::toupper(c))) });
+    finder.AddSymbol({ "\xd1\x8f", "\xd0\xaf" });//UTF-8 ya
+
+    std::string data{ "fin find FIND\xd0\xaf fInD\xd1\x8f" };
+    _assert(finder.Find(data) == 9);
+    _assert(finder.Find(data, 10) == 16);
+    _assert(finder.Find(data, 17) == StrFinder::npos);
+    _assert(finder.Compare(data, 16) == 6);
+}
+
+void MultiStrFinderTest()
+{
+    LOG(DEBUG) << "Test: " << __FUNC__;
+
+    MultiStrFinder finder{ true };
+    finder.AddString("he", 0);
+    finder.AddString("She", 1);
+    finder.AddString({ {"h"}, {"i"}, {"s", "\xc5\xbf"} }, 2);//UTF-8 long s
+    finder.AddString("hers", 3);
+    _assert(finder.Build());
+
+    std::string data{ "ushers HI\xc5\xbf" };
+    _assert(finder.Find(data) == 1);
+    _assert(finder.Find(data, 2) == 2);
+    _assert(finder.Find(data, 5) == 7);
+    _assert(finder.Find(data, 8) == MultiStrFinder::npos);
+
+    std::vector<MultiStrFinder::Match> found;
+    finder.FindAll(data, found);
+    _assert(found.size() == 2);
+    _assert(found[0].pos == 1 && found[0].size == 3 && found[0].id == 1);
+    _assert(found[1].pos == 7 && found[1].size == 4 && found[1].id == 2);
+}
+
+void RegexTest()
+{
+    LOG(DEBUG) << "Test: " << __FUNC__;
+
+    auto find = [](const std::string& pattern, const std::string& str, bool checkCase = true) -> std::string {
+        Regex re(pattern, checkCase);
+        match_t m;
+        if (!re.Match(str, 0, m))
+            return "-";
+        return str.substr(m[0].first, m[0].second - m[0].first);
+    };
+
+    _assert(find("b+", "aabbbc") == "bbb");
+    _assert(find("b+?", "aabbbc") == "b");
+    _assert(find("a|ab", "ab") == "a");
+    _assert(find("(a|ab)(c|bcd)", "abcd") == "abcd");
+    _assert(find("^b", "ab") == "-");
+    _assert(find("b$", "abb") == "b");
+    _assert(find("x*", "abc") == "");
+    _assert(find("[0-9]{2,3}", "a1b2345") == "234");
+    _assert(find("[^a-c]+", "abcdefa") == "def");
+    _assert(find("\\d+\\.\\d*", "v 12.5") == "12.5");
+    _assert(find("\\w+\\s\\w+", "--hello world--") == "hello world");
+    _assert(find("HELLO", "say hello", false) == "hello");
+    _assert(find("[a-z]+", "ABC", false) == "ABC");
+    _assert(find("ж.+к", "уж паук!") == "ж паук");
+    _assert(find("a{", "a{") == "a{");
+    _assert(!Regex("(ab").IsValid());
+    _assert(!Regex("ab)").IsValid());
+    _assert(!Regex("*a").IsValid());
+    _assert(!Regex("[ab").IsValid());
+
+    {
+        Regex re("(\\w+)=(\\d+)");
+        std::string str{ "key=42" };
+        match_t m;
+        [[maybe_unused]] bool rc = re.Match(str, 0, m);
+        _assert(rc && re.GetGroupCount() == 2);
+        _assert(Regex::Expand(str, m, "\\2:\\1") == "42:key");
+    }
+
+    {
+        //next matches in the same string
+        Regex re("\\d+");
+        std::string str{ "1 22 x 333 y" };
+        match_t m;
+        std::vector<std::pair<size_t, size_t>> all;
+        for (size_t pos{}; re.Match(str, pos, m); pos = m[0].second)
+            all.push_back(m[0]);
+        _assert(all.size() == 3 && all[1].first == 2 && all[2].first == 7 && all[2].second == 10);
+        _assert(!re.Match(str, 10, m));
+        _assert(re.Match(str, 4, m) && m[0].first == 7);
+
+        //big line with many matches
+        std::string big;
+        for (size_t i = 0; i < 100000; ++i)
+            big += "ab 12 ";
+        size_t n{};
+        auto t0 = std::chrono::steady_clock::now();
+        for (size_t pos{}; re.Match(big, pos, m); pos = m[0].second)
+            ++n;
+        LOG(DEBUG) << "regex matches=" << n << " time="
+            << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - t0).count();
+        _assert(n == 100000);
+    }
+
+    //compare with std::regex
+    auto bench = [](const std::string& pattern, const std::vector<std::string>& strList) {
+        Regex re(pattern);
+        std::regex sre(pattern);
+
+        auto t0 = std::chrono::steady_clock::now();
+        size_t n1{};
+        for (auto& str : strList)
+            if (re.Search(str))
+                ++n1;
+        auto t1 = std::chrono::steady_clock::now();
+        size_t n2{};
+        for (auto& str : strList)
+            if (std::regex_search(str, sre))
+                ++n2;
+        auto t2 = std::chrono::steady_clock::now();
+
+        LOG(DEBUG) << "regex '" << pattern << "' found=" << n1 << "/" << n2
+            << " time=" << std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count()
+            << "ms std::regex=" << std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count() << "ms";
+        _assert(n1 == n2);
+    };
+
+    std::vector<std::string> logList;
+    for (int i = 0; i < 100000; ++i)
+    {
+        std::stringstream sstr;
+        sstr << "2021-05-" << i % 28 + 10 << " 12:" << i % 60 + 10 << " [" << (i % 7 ? "INFO" : "ERROR") << "] request id=" << i << " done in " << i % 1000 << "ms";
+        logList.push_back(sstr.str());
+    }
+    bench("ERROR.*id=\\d+7 ", logList);
+    bench("(INFO|ERROR)\\] \\w+ id=99", logList);
+    bench("in [0-9]{3}ms$", logList);
+
+    //pathological for backtracking
+    std::vector<std::string> aList(10, std::string(24, 'a'));
+    bench("(a|aa)*c", aList);
+}
+
+void PrintWidthTest()
+{
+    LOG(DEBUG) << "Test: " << __FUNC__;
+    using iconvpp::CpConverter;
+
+    _assert(CpConverter::FixPrintWidth(u"abc", 0, 5) == u"abc  ");
+    _assert(CpConverter::FixPrintWidth(u"a\tbc", 1, 2) == u"\tb");
+    _assert(CpConverter::FixPrintWidth(u"\x5d0\x4e2d", 0, 3) == u"\x5d0\xbf ");
+
+    //compare with width of each character
+    for (uint32_t c = 0; c < 0x10000; ++c)
+    {
+        auto w = widechar_wcwidth(c);
+        char16_t fixed = (w == 1 || w == widechar_ambiguous || c == '\x9') ? static_cast<char16_t>(c) : 0xbf;
+        _assert(CpConverter::FixPrintWidth(std::u16string(1, static_cast<char16_t>(c)), 0, 1)[0] == fixed);
+    }
+
+    auto bench = [](const std::u16string& str) {
+        auto t0 = std::chrono::steady_clock::now();
+        size_t n{};
+        for (int i = 0; i < 100000; ++i)
+            n += CpConverter::FixPrintWidth(str, 0, 100).size();
+        auto t1 = std::chrono::steady_clock::now();
+
+        LOG(DEBUG) << "print width size=" << n
+            << " time=" << std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count() << "ms";
+    };
+
+    bench(u"    for (size_t i = 0; i < size; ++i) sum += data[i]; //ASCII line");
+    bench(u"    //\x43a\x43e\x43c\x43c\x435\x43d\x442\x430\x440\x438\x439 \x43d\x430 \x440\x443\x441\x441\x43a\x43e\x43c");
+}
+
 
 int main()
 {
@@ -131,6 +315,10 @@ int main()
 
     BuffTest();
     CheckDirectoryFunc();
+    RegexTest();
+    StrFinderTest();
+    MultiStrFinderTest();
+    PrintWidthTest();
 
     std::cout << "Utils test finished";
     LOG(INFO) << "End";
@@ -63,6 +63,8 @@ enum class clock_pos
 class Application
 {
     static const inline size_t  s_clockSize{6};
+    static const inline std::chrono::milliseconds s_frameTime{16ms}; //max 60 frames per second
+    static const inline std::chrono::milliseconds s_timerTime{500ms}; //timer event while waiting for output
 public:
     std::string                 m_appName;
 
@@ -58,6 +58,10 @@ enum
   C_WINDOW_SEL,
   C_WINDOW_SEL_LEX_MATCH,
   C_WINDOW_FOUND,
+  C_WINDOW_HIGHLIGHT_1,
+  C_WINDOW_HIGHLIGHT_2,
+  C_WINDOW_HIGHLIGHT_3,
+  C_WINDOW_HIGHLIGHT_4,
   C_WINDOW_DIFF,
   C_WINDOW_NOTDIFF,
   C_WINDOW_CURDIFF,
@@ -106,6 +110,7 @@ extern color_t g_ColorMap[];
 #define ColorWindowSelect       (g_ColorMap[C_WINDOW_SEL])
 #define ColorWindowSelectLMatch (g_ColorMap[C_WINDOW_SEL_LEX_MATCH])
 #define ColorWindowFound        (g_ColorMap[C_WINDOW_FOUND])
+#define ColorWindowHighlight(n) (g_ColorMap[C_WINDOW_HIGHLIGHT_1 + (n) % (C_WINDOW_HIGHLIGHT_4 - C_WINDOW_HIGHLIGHT_1 + 1)])
 #define ColorWindowDiff         (g_ColorMap[C_WINDOW_DIFF])
 #define ColorWindowNotDiff      (g_ColorMap[C_WINDOW_NOTDIFF])
 #define ColorWindowCurDiff      (g_ColorMap[C_WINDOW_CURDIFF])
@@ -334,6 +334,7 @@ public:
 
     //control edit
     std::string GetName() override {return m_edit.GetName();}
+    std::u16string GetWName() override {return m_edit.GetWName();}
 
     //control list
     size_t GetStrCount() { return m_list.GetStrCount(); }
@@ -93,6 +93,7 @@ protected:
     int                 m_disablePaint  {0};
     bool                m_invalidate    {true}; //first paint
     bool                m_invalidTitle  {true};
+    std::string         m_title;
 
 public:
     //view management
@@ -123,11 +124,17 @@ public:
 
     bool    Init();
     bool    Deinit();
+    //run without terminal, input is replayed from script steps
+    bool    SetHeadless(pos_t sizex, pos_t sizey) { return m_console.SetHeadless(sizex, sizey); }
+    bool    AddScriptStep(const std::string& name, const keybuff_t& keys) { return m_console.AddScriptStep(name, keys); }
+    const std::vector<HeadlessStep>& GetScriptReport() { return m_console.GetScriptReport(); }
     bool    SetScreenSize(pos_t sizex = MAX_COORD, pos_t sizey = MAX_COORD) { return m_console.SetScreenSize(sizex, sizey); }
     bool    Resize(pos_t sizex, pos_t sizey);
 
     input_t CheckInput(const std::chrono::milliseconds& waitTime);
+    bool    InputPending(const std::chrono::milliseconds& waitTime = 0ms) { return m_console.InputPending(waitTime); }
     bool    PutInput(input_t code) { return m_console.PutInput(code); }
+    bool    GetPaste(std::vector<std::u16string>& strArray) const;
     input_t ProcInput(input_t code); //events that not treated will pass to active window
     bool    ShowInputCursor(cursor_t nCursor, pos_t x = -1, pos_t y = -1);
     bool    HideCursor();
@@ -138,7 +145,10 @@ public:
     bool    CheckRefresh();
     void    StopPaint()  {++m_disablePaint;}
     void    BeginPaint() { if (m_disablePaint) --m_disablePaint; else { _assert(!"BeginPaint"); } }
-    bool    Flush() { return m_console.Flush(); }
+    bool    Flush() { return ShowDirty() && m_console.Flush(); }
+    bool    OutputPending() const { return m_console.OutputPending(); }
+    bool    WaitOutput(const std::chrono::milliseconds& waitTime) { return m_console.WaitOutput(waitTime); }
+    void    GetOutputStat(size_t& writes, size_t& bytes) const { m_console.GetOutputStat(writes, bytes); }
     void    SetLogo(const Logo& logo) {m_logo = logo;}
     bool    WriteConsoleTitle(bool set = true);
 
@@ -189,7 +199,8 @@ public:
     bool    PutBlock(pos_t left, pos_t top, pos_t right, pos_t bottom, const std::vector<cell_t>& block);
 
 protected:
-    bool    WriteBlock(pos_t left, pos_t top, pos_t right, pos_t bottom, const ScreenBuffer& block);
+    bool    WriteBlock(pos_t left, pos_t top, pos_t right, pos_t bottom);
+    bool    ShowDirty(bool force = false);
 };
 
 } // namespace _WndManager
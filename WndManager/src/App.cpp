@@ -336,23 +336,47 @@ input_t Application::MainProc(input_t exit_code)
 
     [[maybe_unused]]bool rc = false;
     input_t iKey = 0;
+    auto frameTime = std::chrono::steady_clock::now();
+    auto timerTime = frameTime;
 
     while ((iKey & K_TYPEMASK) != exit_code && m_inited)
     {
+        //while input burst is pending frames are shown not more often than s_frameTime
+        bool pending = m_wndManager.m_console.InputPending(0ms);
         rc = m_wndManager.CheckRefresh();
 
-        if (m_insert)
-            rc = m_wndManager.ShowInputCursor(cursor_t::CURSOR_NORMAL);
-        else
-            rc = m_wndManager.ShowInputCursor(cursor_t::CURSOR_OVERWRITE);
+        auto now = std::chrono::steady_clock::now();
+        if (!pending || now - frameTime >= s_frameTime)
+        {
+            if (m_insert)
+                rc = m_wndManager.ShowInputCursor(cursor_t::CURSOR_NORMAL);
+            else
+                rc = m_wndManager.ShowInputCursor(cursor_t::CURSOR_OVERWRITE);
+            frameTime = now;
+        }
 
-        rc = m_wndManager.m_console.InputPending();
+        bool wait = false;
+        if (!pending)
+        {
+            if (m_wndManager.OutputPending())
+            {
+                //let terminal receive the output and show the latest screen after that,
+                //keys, resize and timer are not delayed while waiting
+                wait = m_wndManager.WaitOutput(s_frameTime)
+                    && !m_wndManager.m_console.InputPending(0ms)
+                    && std::chrono::steady_clock::now() - timerTime < s_timerTime;
+            }
+            else
+                rc = m_wndManager.m_console.InputPending();
+        }
         if (ConsoleInput::s_fExit)
         {
             SaveCfg(K_CLOSE);
             LOG(DEBUG) << " A::Main fExit";
             return exit_code;
         }
+        if (wait)
+            continue;
 
         iKey = m_wndManager.m_console.GetInput();
         if (!m_inited)
@@ -360,6 +384,7 @@ input_t Application::MainProc(input_t exit_code)
 
         if (!iKey)
         {
+            timerTime = std::chrono::steady_clock::now();
             PrintClock();
             if (m_capturedInput)
                 iKey = m_capturedInput->EventProc(K_TIME);
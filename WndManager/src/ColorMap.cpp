@@ -55,6 +55,10 @@ color_t g_ColorMap[C_COUNT]
     /*C_WINDOW_SEL       */ FON_RED | FON_GREEN | FON_BLUE,
     /*C_WINDOW_SEL_LMATCH*/ FON_RED | FON_GREEN | FON_BLUE | TEXT_RED |                          TEXT_BRIGHT,
     /*C_WINDOW_FOUND     */           FON_GREEN,
+    /*C_WINDOW_HIGHLIGHT1*/ FON_RED | FON_GREEN,
+    /*C_WINDOW_HIGHLIGHT2*/ FON_RED |             FON_BLUE | TEXT_RED | TEXT_GREEN | TEXT_BLUE | TEXT_BRIGHT,
+    /*C_WINDOW_HIGHLIGHT3*/           FON_GREEN | FON_BLUE,
+    /*C_WINDOW_HIGHLIGHT4*/ FON_RED |                        TEXT_RED | TEXT_GREEN | TEXT_BLUE | TEXT_BRIGHT,
     /*C_WINDOW_DIFF      */                       FON_BLUE | TEXT_RED |                          TEXT_BRIGHT,
     /*C_WINDOW_NOTDIFF   */                       FON_BLUE | TEXT_RED | TEXT_GREEN | TEXT_BLUE,
     /*C_WINDOW_CURDIFF   */                       FON_BLUE | TEXT_RED | TEXT_GREEN |             TEXT_BRIGHT,
@@ -579,10 +579,11 @@ input_t CtrlEdit::EventProc(input_t code)
             return code;
     }
     else if (code == (K_INSERT | K_SHIFT)
-          || code == ('V' | K_CTRL))
+          || code == ('V' | K_CTRL)
+          || code == K_PASTE)
     {
         std::vector<std::u16string> strArray;
-        bool rc = PasteFromClipboard(strArray);
+        bool rc = code == K_PASTE ? WndManager::getInstance().GetPaste(strArray) : PasteFromClipboard(strArray);
         if (rc)
         {
             //LOG(DEBUG) << "     Paste";
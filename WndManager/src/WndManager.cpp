@@ -204,7 +204,8 @@ bool WndManager::Cls()
     //LOG(DEBUG) << "  M::Cls";
 
     HideCursor();
-    bool rc = CallConsole(ClrScr());
+    bool rc = CallConsole(ClrScr())
+        && WriteBlock(0, 0, m_sizex - 1, m_sizey - 1);
     return rc;
 }
 
@@ -214,16 +215,14 @@ bool WndManager::SetTextAttr(color_t color)
     //LOG(DEBUG) << __FUNC__ << " c=" << std::hex << color << std::dec;
     _assert(TEXT_COLOR(color) != FON_COLOR(color));
     m_color = color;
-    bool rc = CallConsole(SetTextAttr(color));
-    return rc;
+    return true;
 }
 
 bool WndManager::GotoXY(pos_t x, pos_t y)
 {
     m_cursorx = x;
     m_cursory = y;
-    bool rc = CallConsole(GotoXY(x, y));
-    return rc;
+    return true;
 }
 
 bool WndManager::ShowInputCursor(cursor_t cursor, pos_t x, pos_t y)
@@ -250,17 +249,20 @@ bool WndManager::ShowInputCursor(cursor_t cursor, pos_t x, pos_t y)
         }
     }
 
-    bool rc = true;
-    if (m_cursorx != x || m_cursory != y || m_cursor != cursor)
-    {
-        rc = m_console.GotoXY(x, y)
-          && m_console.SetCursor(cursor)
-          && m_console.Flush();
+    m_cursorx = x;
+    m_cursory = y;
 
-        m_cursorx = x;
-        m_cursory = y;
-        m_cursor  = cursor;
-    }
+    //terminal did not receive previous frame yet, this one is dropped
+    if (m_console.OutputPending())
+        return m_console.Flush();
+
+    //end of frame
+    bool rc = ShowDirty()
+        && m_console.GotoXY(x, y)
+        && m_console.SetCursor(cursor)
+        && m_console.Flush();
+
+    m_cursor  = cursor;
 
     return rc;
 }
@@ -276,13 +278,12 @@ bool WndManager::HideCursor()
     return rc;
 }
 
+//screen buffer tracks changed cells, they are shown at the end of frame
 bool WndManager::ShowBuff()
 {
     if (0 == m_screenBuff.GetSize())
         return false;
-
-    bool rc = WriteBlock(0, 0, m_sizex - 1, m_sizey - 1, m_screenBuff);
-    return rc;
+    return true;
 }
 
 bool WndManager::ShowBuff(pos_t left, pos_t top, pos_t sizex, pos_t sizey)
@@ -290,18 +291,72 @@ bool WndManager::ShowBuff(pos_t left, pos_t top, pos_t sizex, pos_t sizey)
     if (0 == m_screenBuff.GetSize())
         return false;
 
-    bool rc = false;
     if (left < 0 || top < 0 || left + sizex > m_sizex || top + sizey > m_sizey)
+    {
         LOG(ERROR) << __FUNC__ << "  M::ShowBuff l=" << left << " t=" << top << " sx=" << sizex << " sy=" << sizey;
-    else
-        rc = WriteBlock(left, top, left + sizex - 1, top + sizey - 1, m_screenBuff);
-    return rc;
+        return false;
+    }
+    return true;
 }
 
-bool WndManager::WriteBlock(pos_t left, pos_t top, pos_t right, pos_t bottom, const ScreenBuffer& block)
+bool WndManager::WriteBlock(pos_t left, pos_t top, pos_t right, pos_t bottom)
 {
     HideCursor();
-    bool rc = CallConsole(WriteBlock(left, top, right, bottom, block, left, top));
+    if (m_disablePaint)
+        return true;
+
+    //block will be shown again though buffer was not changed
+    left   = std::max<pos_t>(left, 0);
+    top    = std::max<pos_t>(top, 0);
+    right  = std::min<pos_t>(right, m_sizex - 1);
+    bottom = std::min<pos_t>(bottom, m_sizey - 1);
+    if (left <= right && top <= bottom)
+        m_screenBuff.MarkDirty(left, top, right, bottom);
+
+    return true;
+}
+
+bool WndManager::ShowDirty(bool force)
+{
+    if (!m_screenBuff.IsDirty() || m_disablePaint)
+        return true;
+    if (!force && m_console.OutputPending())
+        //terminal is busy, only the latest state will be shown
+        return true;
+
+    HideCursor();
+
+    //each group of changed lines is written as one block
+    bool rc = true;
+    pos_t top = -1;
+    size_t left{};
+    size_t right{};
+    for (pos_t y = 0; y <= m_sizey; ++y)
+    {
+        size_t l, r;
+        if (y < m_sizey && m_screenBuff.GetDirty(y, l, r))
+        {
+            if (top < 0)
+            {
+                top = y;
+                left = l;
+                right = r;
+            }
+            else
+            {
+                left = std::min(left, l);
+                right = std::max(right, r);
+            }
+        }
+        else if (top >= 0)
+        {
+            pos_t x = static_cast<pos_t>(left);
+            rc = m_console.WriteBlock(x, top, static_cast<pos_t>(right), y - 1, m_screenBuff, x, top) && rc;
+            top = -1;
+        }
+    }
+
+    m_screenBuff.ClearDirty();
     return rc;
 }
 
@@ -319,14 +374,12 @@ bool WndManager::PutBlock(pos_t left, pos_t top, pos_t right, pos_t bottom, cons
     if (block.empty())
         return true;
 
-    HideCursor();
     size_t i = 0;
     for (pos_t x = left; x <= right; ++x)
         for (pos_t y = top; y <= bottom; ++y)
             m_screenBuff.SetCell(x, y, block[i++]);
 
-    bool rc = WriteBlock(left, top, right, bottom, m_screenBuff);
-    return rc;
+    return true;
 }
 
 bool WndManager::WriteStr(const std::string& str)
@@ -338,51 +391,21 @@ bool WndManager::WriteStr(const std::string& str)
     
 bool WndManager::WriteWStr(const std::u16string& wstr)
 {
-    HideCursor();
-
-    size_t l = wstr.size();
-    bool rc;
-    if (m_cursory != m_sizey - 1 || m_cursorx + static_cast<pos_t>(l) <= m_sizex - 1)
-        rc = CallConsole(WriteStr(wstr));
-    else
-    {
-        char16_t PrevC = wstr[l - 2];
-        char16_t LastC = wstr[l - 1];
-        rc = CallConsole(WriteStr(wstr.substr(0, l - 1)));
-        rc = CallConsole(WriteLastChar(PrevC, LastC));
-    }
-
-    for(const auto& c : wstr)
-        m_screenBuff.SetCell(m_cursorx++, m_cursory, MAKE_CELL(0, m_color, c));
-
+    bool rc = m_screenBuff.WriteSpan(m_cursorx, m_cursory, wstr, m_color);
+    m_cursorx += static_cast<pos_t>(wstr.size());
     return rc;
 }
 
 bool WndManager::WriteColorWStr(const std::u16string& str, const std::vector<color_t>& color)
 {
-    HideCursor();
-
-    pos_t x = m_cursorx;
-    pos_t y = m_cursory;
-    pos_t len = static_cast<pos_t>(str.size());
-    for(pos_t i = 0; i < len; ++i)
-        m_screenBuff.SetCell(m_cursorx++, m_cursory, MAKE_CELL(0, color[i], str[i]));
-
-    bool rc = CallConsole(WriteBlock(x, y, x + len - 1, y, m_screenBuff, x, y));
+    bool rc = m_screenBuff.WriteSpan(m_cursorx, m_cursory, str, color);
+    m_cursorx += static_cast<pos_t>(str.size());
     return rc;
 }
 
 bool WndManager::WriteColor(pos_t x, pos_t y, const std::vector<color_t>& color)
 {
-    HideCursor();
-    pos_t len = static_cast<pos_t>(color.size());
-
-    for (pos_t i = 0; i < len; ++i)
-    {
-        m_screenBuff.SetColor(x + i, y, color[i]);
-    }
-
-    bool rc = CallConsole(WriteBlock(x, y, x + len - 1, y, m_screenBuff, x, y));
+    bool rc = m_screenBuff.ColorSpan(x, y, color);
     return rc;
 }
 
@@ -439,7 +462,13 @@ bool WndManager::WriteConsoleTitle(bool set)
         }
     }
 
-    bool rc = m_console.WriteConsoleTitle(name + " - " + Application::getInstance().m_appName);
+    //the same title isn't sent again
+    auto title = name + " - " + Application::getInstance().m_appName;
+    if (!set && title == m_title)
+        return true;
+    m_title = title;
+
+    bool rc = m_console.WriteConsoleTitle(title);
 
     return rc;
 }
@@ -454,18 +483,8 @@ bool WndManager::WriteChar(char c)
 bool WndManager::WriteWChar(char16_t c)
 {
     //LOG(DEBUG) << __FUNC__ << std::hex << c << std::dec;
-    HideCursor();
-    bool rc = true;
-    if (m_cursory != m_sizey - 1 || m_cursorx < m_sizex - 1)
-        rc = CallConsole(WriteChar(c));
-    else
-    {
-        char16_t PrevC = GET_CTEXT(m_screenBuff.GetCell(static_cast<size_t>(m_cursorx) - 1, m_cursory));
-        rc = CallConsole(WriteLastChar(PrevC, c));
-    }
-
-    m_screenBuff.SetCell(m_cursorx++, m_cursory, MAKE_CELL(0, m_color, c));
-
+    bool rc = m_screenBuff.SetCell(m_cursorx, m_cursory, MAKE_CELL(0, m_color, c));
+    ++m_cursorx;
     return rc;
 }
 
@@ -474,17 +493,14 @@ bool WndManager::FillRect(pos_t left, pos_t top, pos_t sizex, pos_t sizey, input
     //LOG(DEBUG) << "  M::FillRect l=" << left << " t=" << top << " sx=" << sizex << " sy=" << sizey 
     //    << " ch=" << std::hex << c << " color=" << static_cast<int>(color) << std::dec;
 
-    HideCursor();
+    if (sizex <= 0)
+        return true;
+
+    bool rc = true;
     cell_t cl = MAKE_CELL(0, color, c);
     for (pos_t y = 0; y < sizey; ++y)
-    {
-        for (pos_t x = 0; x < sizex; ++x)
-        {
-            m_screenBuff.SetCell(static_cast<size_t>(left) + x, static_cast<size_t>(top) + y, cl);
-        }
-    }
+        rc = m_screenBuff.FillSpan(left, static_cast<size_t>(top) + y, sizex, cl) && rc;
 
-    bool rc = CallConsole(WriteBlock(left, top, left + sizex - 1, top + sizey - 1, m_screenBuff, left, top));
     return rc;
 }
 
@@ -492,16 +508,14 @@ bool WndManager::ColorRect(pos_t left, pos_t top, pos_t sizex, pos_t sizey, colo
 {
     //LOG(DEBUG) << "  M::ColorRect l=" << left << " t=" << top << " x=" << sizex << " y=" << sizey << " color=" << color;
 
-    HideCursor();
+    if (sizex <= 0)
+        return true;
+
+    bool rc = true;
+    std::vector<color_t> colors(sizex, color);
     for (pos_t y = 0; y < sizey; ++y)
-    {
-        for (pos_t x = 0; x < sizex; ++x)
-        {
-            m_screenBuff.SetColor(static_cast<size_t>(left) + x, static_cast<size_t>(top) + y, color);
-        }
-    }
+        rc = m_screenBuff.ColorSpan(left, static_cast<size_t>(top) + y, colors) && rc;
 
-    int rc = CallConsole(WriteBlock(left, top, left + sizex - 1, top + sizey - 1, m_screenBuff, left, top));
     return rc;
 }
 
@@ -509,7 +523,6 @@ bool WndManager::InvColorRect(pos_t left, pos_t top, pos_t sizex, pos_t sizey)
 {
     //LOG(DEBUG) << "  M::InvColorRect l=" << left << " t=" << top << " sx=" << sizex << " sy=" << sizey;
 
-    HideCursor();
     for (pos_t y = 0; y < sizey; ++y)
     {
         for (pos_t x = 0; x < sizex; ++x)
@@ -518,9 +531,7 @@ bool WndManager::InvColorRect(pos_t left, pos_t top, pos_t sizex, pos_t sizey)
             m_screenBuff.SetColor(static_cast<size_t>(left) + x, static_cast<size_t>(top) + y, color);
         }
     }
-
-    int rc = CallConsole(WriteBlock(left, top, left + sizex - 1, top + sizey - 1, m_screenBuff, left, top));
-    return rc;
+    return true;
 }
 
 bool WndManager::Show(Wnd* wnd, bool refresh, int view)
@@ -796,8 +807,9 @@ input_t WndManager::ProcInput(input_t code)
 
     if (code == K_REFRESH)
     {
-        //refresh
+        //refresh all screen
         //LOG(DEBUG) << "WndManager Refresh";
+        Cls();
         Refresh();
         out = 0;
     }
@@ -998,7 +1010,8 @@ bool WndManager::TrackView(const std::string& msg)
     bool loop = true;
     while (loop)
     {
-        input_t iKey = m_console.InputPending(500ms);
+        Flush();
+        input_t iKey = InputPending(500ms);
 
         Application::getInstance().PrintClock();
         if (iKey)
@@ -1070,7 +1083,8 @@ bool WndManager::TrackView(const std::string& msg)
 
 input_t WndManager::CheckInput(const std::chrono::milliseconds& waitTime)
 {
-    bool key = m_console.InputPending(waitTime);
+    Flush();
+    bool key = InputPending(waitTime);
 
     Application::getInstance().PrintClock();
     if (key)
@@ -1086,19 +1100,45 @@ input_t WndManager::CheckInput(const std::chrono::milliseconds& waitTime)
     return 0;
 }
 
+bool WndManager::GetPaste(std::vector<std::u16string>& strArray) const
+{
+    //text of the last K_PASTE event split to lines
+    const auto& paste = m_console.GetPaste();
+    strArray.clear();
+    strArray.emplace_back();
+    for (size_t i = 0; i < paste.size(); ++i)
+    {
+        char16_t c = paste[i];
+        if (c == '\r' || c == '\n')
+        {
+            if (c == '\r' && i + 1 < paste.size() && paste[i + 1] == '\n')
+                ++i;
+            strArray.emplace_back();
+        }
+        else
+            strArray.back() += c;
+    }
+
+    return !paste.empty();
+}
+
 bool WndManager::Scroll(pos_t left, pos_t top, pos_t right, pos_t bottom, pos_t n, scroll_t mode)
 {
     uint32_t invalidate{};
 
+    //terminal must show current buffer before scrolling
     HideCursor();
-    bool rc = CallConsole(ScrollBlock(left, top, right, bottom, n, mode, &invalidate));
+    bool rc = ShowDirty(true);
+    rc = CallConsole(ScrollBlock(left, top, right, bottom, n, mode, &invalidate));
     rc = m_screenBuff.ScrollBlock(left, top, right, bottom, n, mode);
+    //terminal cleared vacated cells, moved ones are skipped by console as unchanged
+    m_screenBuff.MarkDirty(left, top, right, bottom);
 
     if ((invalidate & INVALIDATE_LEFT) && left > 0)
-        rc = WriteBlock(0, top, left - 1, bottom, m_screenBuff);
+        rc = WriteBlock(0, top, left - 1, bottom);
 
     if ((invalidate & INVALIDATE_RIGHT) && right < m_sizex - 1)
-        rc = WriteBlock(right + 1, top, m_sizex - 1, bottom, m_screenBuff);
+        rc = WriteBlock(right + 1, top, m_sizex - 1, bottom);
 
     return rc;
 }
@@ -33,7 +33,9 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "WndManager/App.h"
 #include "WndManager/DlgControls.h"
 
+#include <iomanip>
 #include <iostream>
+#include <chrono>
 
 using namespace _Utils;
 using namespace _WndManager;
@@ -141,12 +143,35 @@ public:
 MyApp app;
 Application& Application::s_app{app};
 
-int main()
+int main(int argc, char** argv)
 {
+    bool bench = argc > 1 && std::string(argv[1]) == "bench";
+    bool headless = argc > 1 && std::string(argv[1]) == "headless";
+
     ConfigureLogger("m-%datetime{%Y%M%d}.log", 0x200000, false);
     LOG(INFO);
     LOG(INFO) << "Winman test";
 
+    if (headless)
+    {
+        //same navigation without terminal, key by key
+        auto& wndManager = WndManager::getInstance();
+        wndManager.SetHeadless(100, 30);
+        keybuff_t menu;
+        keybuff_t dialog;
+        for (size_t i = 0; i < 10; ++i)
+        {
+            menu.push_back(K_F2);
+            menu.insert(menu.end(), 6, K_RIGHT);
+            menu.push_back(K_ESC);
+            dialog.push_back(K_F3);
+            dialog.push_back(K_ESC);
+        }
+        wndManager.AddScriptStep("menu", menu);
+        wndManager.AddScriptStep("dialog", dialog);
+        wndManager.AddScriptStep("exit", {K_F1});
+    }
+
     //Application& app = Application::getInstance();
     //MyApp app;
     app.Init();
@@ -160,10 +185,47 @@ int main()
     app.SetClock(clock_pos::bottom);
     
     app.Refresh();
-    app.MainProc(K_F1);
 
+    if (bench)
+    {
+        //input burst: 10000 keys of menu and dialog navigation played as macro
+        app.RecordMacro();
+        for (size_t i = 0; i < 1000; ++i)
+        {
+            app.PutMacro(K_F2);
+            for (size_t n = 0; n < 6; ++n)
+                app.PutMacro(K_RIGHT);
+            app.PutMacro(K_ESC);
+            app.PutMacro(K_F3);
+            app.PutMacro(K_ESC);
+        }
+        app.RecordMacro();
+        app.PlayMacro();
+        app.PutCode(K_F1);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    app.MainProc(K_F1);
+    auto time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    size_t writes{};
+    size_t bytes{};
+    WndManager::getInstance().GetOutputStat(writes, bytes);
+    std::vector<HeadlessStep> steps;
+    if (headless)
+        steps = WndManager::getInstance().GetScriptReport();
     app.Deinit();
 
+    for (auto& step : steps)
+        std::cout << std::left << std::setw(8) << step.name << std::right
+            << " bytes=" << std::setw(7) << step.bytes << " flushes=" << std::setw(4) << step.flushes
+            << " frames=" << std::setw(4) << step.frames << " time=" << step.time.count() << "us" << std::endl;
+    if (headless)
+        std::cout << "frames=" << writes << " bytes=" << bytes << " time=" << time.count() << "ms" << std::endl;
+
+    if (bench)
+        std::cout << "writes=" << writes << " bytes=" << bytes << " time=" << time.count() << "ms" << std::endl;
+
     LOG(INFO) << "End";
     return 0;
 }
\ No newline at end of file